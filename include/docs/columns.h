@@ -0,0 +1,57 @@
+/************************************************************************************
+    Copyright (C) 2019 Georg Richter and MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+PyDoc_STRVAR(
+  column_buffer__doc__,
+  "Values of a result set column returned by cursor.fetch_columns().\n\n"
+  "The column buffer supports the buffer protocol: for fixed size types\n"
+  "(int64, uint64, double, date32, timestamp[us] and duration[us]) it\n"
+  "exports the values as contiguous array, for variable length types\n"
+  "(utf8 and binary) the concatenated data, which can be split by the\n"
+  "offsets attribute. NULL values are marked in the validity bitmap."
+);
+
+PyDoc_STRVAR(
+  column_buffer_name__doc__,
+  "Column name"
+);
+
+PyDoc_STRVAR(
+  column_buffer_type__doc__,
+  "Type of column values: int64, uint64, double, date32 (days since\n"
+  "1970-01-01), timestamp[us] (microseconds since 1970-01-01 00:00:00),\n"
+  "duration[us] (microseconds), utf8 or binary"
+);
+
+PyDoc_STRVAR(
+  column_buffer_null_count__doc__,
+  "Number of NULL values"
+);
+
+PyDoc_STRVAR(
+  column_buffer_validity__doc__,
+  "Validity bitmap (bytes) in least significant bit order: a set bit\n"
+  "indicates that the value is not NULL"
+);
+
+PyDoc_STRVAR(
+  column_buffer_offsets__doc__,
+  "For variable length types (utf8 and binary) bytes containing len() + 1\n"
+  "int64 offsets into the data, None for fixed size types"
+);
@@ -93,6 +93,17 @@ PyDoc_STRVAR(
   "Fetches next row of a pending result set and returns a tuple.\n"
 );
 
+PyDoc_STRVAR(
+  cursor_fetchall__doc__,
+  "fetchall()\n"
+  "--\n"
+  "\n"
+  "Fetch all remaining rows of a query result, returning them as a\n"
+  "sequence of sequences (e.g. a list of tuples).\n\n"
+  "An exception will be raised if the previous call to execute() didn't\n"
+  "produce a result set or execute() wasn't called before."
+);
+
 PyDoc_STRVAR(
   cursor_field_count__doc__,
   "field_count()\n"
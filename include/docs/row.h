@@ -0,0 +1,34 @@
+/************************************************************************************
+    Copyright (C) 2019 Georg Richter and MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+PyDoc_STRVAR(
+  row__doc__,
+  "Row returned by a cursor which was created with lazy=True.\n\n"
+  "The row keeps a copy of the raw row data and converts a column value\n"
+  "only when it is accessed. Columns can be accessed by index, slice or\n"
+  "column name."
+);
+
+PyDoc_STRVAR(
+  row_materialize__doc__,
+  "materialize()\n"
+  "--\n"
+  "\n"
+  "Converts all column values and returns the row as tuple."
+);
@@ -42,6 +42,10 @@ static inline void _Py_SET_TYPE(PyObject *ob, PyTypeObject *type)
 #define Py_SET_TYPE(ob, type) _Py_SET_TYPE((PyObject*)(ob), type)
 #endif
 
+#if PY_VERSION_HEX < 0x03090000
+#define PyObject_Vectorcall _PyObject_Vectorcall
+#endif
+
 #if defined(_WIN32)
 #include <config_win.h>
 #include <windows.h>
@@ -54,6 +58,12 @@ typedef CRITICAL_SECTION pthread_mutex_t;
 #define pthread_mutex_unlock(A)  LeaveCriticalSection(A)
 #define pthread_mutex_destroy(A) DeleteCriticalSection(A)
 #define pthread_self() GetCurrentThreadId()
+typedef CONDITION_VARIABLE pthread_cond_t;
+#define pthread_cond_init(A,B)   InitializeConditionVariable(A)
+#define pthread_cond_wait(A,B)   SleepConditionVariableCS((A),(B),INFINITE)
+#define pthread_cond_signal(A)   WakeConditionVariable(A)
+#define pthread_cond_broadcast(A) WakeAllConditionVariable(A)
+#define pthread_cond_destroy(A)
 #include <malloc.h>
 #else
 #include <pthread.h>
@@ -145,6 +155,9 @@ int clock_gettime(int dummy, struct timespec *ct);
 #define MAX_TPC_XID_SIZE 64
 #define POOL_DEFAULT_SIZE 5
 
+/* Max. number of cached named tuple types per connection */
+#define MAX_NAMED_TUPLE_TYPES 32
+
 /* Placeholder for missing documentation */
 #define MISSING_DOC NULL
 
@@ -188,7 +201,16 @@ enum enum_result_format
 {
     RESULT_TUPLE= 0,
     RESULT_NAMED_TUPLE,
-    RESULT_DICTIONARY
+    RESULT_DICTIONARY,
+    RESULT_LAZY
+};
+
+enum enum_decimal_format
+{
+    DECIMAL_FORMAT_DECIMAL= 0,
+    DECIMAL_FORMAT_STR,
+    DECIMAL_FORMAT_FLOAT,
+    DECIMAL_FORMAT_INT
 };
 
 enum enum_dyncol_type
@@ -228,6 +250,7 @@ typedef struct st_parser {
     uint8_t in_comment;
     uint8_t in_values;
     uint8_t is_insert;
+    uint8_t has_returning;
     uint8_t comment_eol;
     uint32_t param_count;
     uint32_t key_count;
@@ -268,6 +291,20 @@ typedef struct {
     PyObject *last_executed_stmt;
     PyObject *converter;
     uint8_t tls_in_use;
+    uint8_t decimal_format;
+    PyObject *named_tuple_types; /* list of (column names, type) tuples */
+    struct st_mrdb_prefetch *prefetch; /* active background reader */
+    /* extended server capabilities, updated on (re)connect and
+       change_user */
+    unsigned long ext_capabilities;
+    /* minimum of client and server max_allowed_packet, read on demand
+       and reset together with ext_capabilities */
+    unsigned long max_allowed_packet;
+    /* statement handles of released result holders, closed before the
+       next command (see MrdbConnection_ClosePendingStatements) */
+    MYSQL_STMT **pending_stmts;
+    uint32_t pending_stmt_count;
+    uint32_t pending_stmt_size;
 } MrdbConnection;
 
 typedef struct {
@@ -296,6 +333,32 @@ typedef struct {
     MYSQL_TIME tm;
 } MrdbParamValue;
 
+/* Column-wise parameter arrays for cursor.executemany() */
+typedef union {
+    int64_t ll;
+    uint64_t ull;
+    double d;
+    size_t offset; /* decimal: offset in arena */
+    const char *str;
+} MrdbBulkValue;
+
+typedef struct {
+    enum enum_field_types type;
+    uint8_t is_unsigned;
+    int64_t min; /* range of integer values */
+    uint64_t max;
+    MrdbBulkValue *values;
+    unsigned long *length;
+    char *indicator;
+    MYSQL_TIME *tm;
+    char *arena; /* string representation of decimal values */
+    size_t arena_length;
+    size_t arena_size;
+    size_t size; /* estimated size of the values in the bulk request */
+    Py_buffer view; /* columnar data: values and null mask */
+    Py_buffer mask;
+} MrdbBulkColumn;
+
 typedef struct {
     char *statement;
     Py_ssize_t statement_len;
@@ -303,10 +366,195 @@ typedef struct {
     enum enum_binary_command command;
     uint32_t paramcount;
     uint8_t is_text;
+    uint8_t has_returning;
     PyObject *paramlist;
     PyObject *keys;
 } MrdbParseInfo;
 
+/* Per column cache for string values: values of low cardinality columns
+   (ENUM, SET or status columns) are looked up by their raw bytes, so
+   identical values share the same unicode object */
+#define MRDB_STRING_CACHE_SLOTS 128     /* must be a power of 2 */
+#define MRDB_STRING_CACHE_MAX_LENGTH 64 /* longer values are not cached */
+#define MRDB_STRING_CACHE_CHECK 1024    /* lookups before checking hit rate */
+
+typedef struct {
+    PyObject *value;
+    uint32_t hash;
+    unsigned long length;
+    unsigned long char_length;
+    unsigned char key[MRDB_STRING_CACHE_MAX_LENGTH];
+} MrdbStringCacheEntry;
+
+typedef struct {
+    uint64_t lookups;
+    uint64_t hits;
+    MrdbStringCacheEntry entries[MRDB_STRING_CACHE_SLOTS];
+} MrdbStringCache;
+
+/* Per column cache for DATE and DATETIME values, keyed by the packed
+   date and time */
+#define MRDB_TEMPORAL_CACHE_SLOTS 64    /* must be a power of 2 */
+#define MRDB_TEMPORAL_CACHE_CHECK 1024  /* lookups before checking hit rate */
+
+typedef struct {
+    uint64_t key;
+    PyObject *value;
+} MrdbTemporalCacheEntry;
+
+typedef struct {
+    uint64_t lookups;
+    uint64_t hits;
+    MrdbTemporalCacheEntry entries[MRDB_TEMPORAL_CACHE_SLOTS];
+} MrdbTemporalCache;
+
+/* Column decode plan:
+   Type, flags and extended type of a column don't change while reading
+   a result set, so they are evaluated once in MrdbCursor_InitResultSet
+   and the row fetch just calls the resolved decode function */
+typedef struct st_mrdb_column MrdbColumn;
+
+/* Decodes a single non NULL column value and returns a new reference
+   or NULL if an error occurred. For binary protocol row points to the
+   current position in the row buffer and will be advanced, for text
+   protocol *row points to the column data with the given length. */
+typedef PyObject *(*MrdbColumn_Decode)(MrdbColumn *column,
+                                       unsigned char **row,
+                                       unsigned long length);
+
+struct st_mrdb_column {
+    MrdbColumn_Decode decode;
+    /* binary protocol: decoder for the value of length encoded columns */
+    MrdbColumn_Decode decode_value;
+    enum enum_field_types type;
+    enum enum_extended_field_type ext_type;
+    enum enum_field_types converter_type;
+    PyObject *converter; /* resolved from connection converter or NULL */
+    PyObject *name; /* interned column name (dictionary results) */
+    uint8_t is_unsigned;
+    uint8_t is_binary;
+    unsigned int decimals;
+    uint8_t decimal_format;
+    unsigned long max_length;
+    MrdbStringCache *string_cache;
+    MrdbTemporalCache *temporal_cache;
+    PyObject *owner; /* result holder of memoryview values (borrowed) */
+    /* binary protocol: raw value of the current row (open_blob) */
+    unsigned char *current;
+};
+
+/* The column plan is a (private) Python object, so it can be shared
+   between the cursor and lazy rows, which might outlive the result set */
+typedef struct {
+    PyObject_HEAD
+    MrdbColumn *columns;
+    uint32_t column_count;
+    uint8_t is_text;
+    PyObject *column_index; /* column name -> index (lazy rows) */
+} MrdbColumnPlan;
+
+/* Raw column data as received from server, data is NULL for NULL values.
+   For binary protocol data points to the encoded value (including the
+   length prefix), for text protocol to the column data */
+typedef struct {
+    unsigned char *data;
+    unsigned long length;
+} MrdbRawValue;
+
+/* Lazy row: keeps a copy of the raw row data and the column plan,
+   columns are decoded on first access */
+typedef struct {
+    PyObject_HEAD
+    MrdbColumnPlan *plan;
+    PyObject **values; /* decoded values, NULL if not decoded yet */
+    MrdbRawValue *raw;
+} MrdbRow;
+
+/* Columnar fetch: values of a column are stored in contiguous buffers,
+   NULL values are marked in a validity bitmap (bit set: not NULL) */
+enum enum_column_buffer_type
+{
+    COLUMN_BUFFER_INT64= 0,
+    COLUMN_BUFFER_UINT64,
+    COLUMN_BUFFER_DOUBLE,
+    COLUMN_BUFFER_DATE32,     /* days since 1970-01-01 */
+    COLUMN_BUFFER_TIMESTAMP,  /* microseconds since 1970-01-01 00:00:00 */
+    COLUMN_BUFFER_DURATION,   /* microseconds */
+    /* binary protocol sends the following types length encoded */
+    COLUMN_BUFFER_UTF8,       /* offsets + data */
+    COLUMN_BUFFER_BINARY,     /* offsets + data */
+    COLUMN_BUFFER_DECIMAL128  /* 128-bit unscaled value (Arrow export) */
+};
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *name;
+    enum enum_column_buffer_type type;
+    enum enum_field_types field_type;
+    uint8_t is_unsigned;
+    uint8_t is_text;
+    uint8_t item_size;     /* 0 for variable length values */
+    unsigned int precision;
+    unsigned int scale;
+    Py_ssize_t length;     /* number of values */
+    Py_ssize_t null_count;
+    unsigned char *data;   /* values or variable length data */
+    size_t data_length;
+    size_t data_size;
+    uint8_t *validity;
+    size_t validity_size;
+    int64_t *offsets;      /* length + 1 offsets into data */
+    size_t offsets_size;
+    Py_ssize_t shape;      /* buffer protocol */
+} MrdbColumnBuffer;
+
+/* Arrow C data and C stream interface, as defined in
+   https://arrow.apache.org/docs/format/CDataInterface.html */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+    void (*release)(struct ArrowSchema *);
+    void *private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+    void (*release)(struct ArrowArray *);
+    void *private_data;
+};
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    int (*get_schema)(struct ArrowArrayStream *, struct ArrowSchema *out);
+    int (*get_next)(struct ArrowArrayStream *, struct ArrowArray *out);
+    const char *(*get_last_error)(struct ArrowArrayStream *);
+    void (*release)(struct ArrowArrayStream *);
+    void *private_data;
+};
+#endif
+
 /* PEP-249: Cursor object */
 typedef struct {
     PyObject_HEAD
@@ -319,30 +567,135 @@ typedef struct {
     MrdbParamInfo *paraminfo;
     MrdbParamValue *value;
     MYSQL_BIND *params;
+    MrdbBulkColumn *bulk; /* parameter arrays of executemany() */
     MYSQL_BIND *bind;
     MYSQL_FIELD *fields;
     char *statement;
     size_t statement_len;
     PyObject **values;
-    PyStructSequence_Field *sequence_fields;
+    MrdbColumnPlan *plan;
+    MrdbRawValue *raw_values; /* current row (lazy rows, columnar fetch) */
+    PyObject *row_template; /* dictionary with column names as keys */
     PyTypeObject *sequence_type;
     MrdbParseInfo parseinfo;
     unsigned long prefetch_rows;
+    unsigned long fetch_rows; /* rows per COM_STMT_FETCH */
+    unsigned long fetch_buffer_size; /* byte budget of adaptive fetch size */
+    uint64_t batch_rows; /* rows and bytes fetched since last COM_STMT_FETCH */
+    uint64_t batch_bytes;
+    uint64_t row_bytes; /* raw size of the last fetched row */
+    uint8_t measure_bytes; /* calculate row_bytes */
     unsigned long cursor_type;
     int64_t affected_rows;
     uint32_t field_count;
     int64_t row_count;
     uint64_t lastrow_id;
     uint64_t row_number;
+    PyObject *read_ahead; /* rows decoded in advance by the iterator */
+    Py_ssize_t read_ahead_pos;
     enum enum_result_format result_format;
     uint8_t is_prepared;
     char is_buffered;
     uint8_t fetched;
     uint8_t closed;
     uint8_t reprepare;
+    uint8_t decimal_format;
+    uint8_t intern_strings;
+    uint8_t fetch_raw; /* fetch raw values into raw_values */
+    uint32_t prefetch_capacity; /* ring size for unbuffered prefetch */
+    struct st_mrdb_prefetch *prefetch;
+    uint8_t blob_as_memoryview;
+    uint8_t stream_blobs; /* BLOB values are read with open_blob() only */
+    struct st_mrdb_result_holder *result_holder;
+    uint64_t row_serial; /* changes whenever the current row changes */
+    uint8_t has_row; /* raw data of current row is accessible */
+    MYSQL_ROW current_row; /* text protocol: current row (open_blob) */
+    unsigned long *current_lengths;
+    uint64_t buffer_limit; /* max. memory of buffered results (spool) */
+    struct st_mrdb_spool *spool;
     enum enum_paramstyle paramstyle;
 } MrdbCursor;
 
+/* Buffered result set with a memory limit: rows are read unbuffered
+   and stored in a packed format (for each column a 4 byte length,
+   SPOOL_NULL_LENGTH for NULL values, followed by the raw data). If the
+   size exceeds the limit, rows will be written to a temporary file,
+   which will be mapped into memory after all rows were read. */
+typedef struct st_mrdb_spool {
+    unsigned char *data; /* memory buffer or file mapping */
+    size_t data_size;
+    size_t size; /* size of all rows */
+    uint64_t *offsets; /* offset of each row */
+    uint64_t offsets_size;
+    uint64_t row_count;
+    uint64_t position;
+    uint64_t limit;
+    uint32_t field_count;
+    uint8_t is_text;
+    MrdbRawValue *raw; /* raw values of the current row */
+    unsigned char *row_buffer; /* packed row before writing to file */
+    size_t row_buffer_size;
+    FILE *file;
+    uint8_t mapped;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+} MrdbSpool;
+
+#define SPOOL_NULL_LENGTH UINT32_MAX
+
+/* Owns the buffered result set of a cursor as long as memoryviews of
+   binary columns (blob_as_memoryview) refer to it. If views are still
+   referenced when the cursor releases the result, the statement handle
+   or result will be moved into the holder. */
+typedef struct st_mrdb_result_holder {
+    PyObject_HEAD
+    MrdbConnection *connection;
+    MYSQL_STMT *stmt;
+    MYSQL_RES *result;
+} MrdbResultHolder;
+
+/* Exports a single column value of a held result set as read only
+   buffer */
+typedef struct {
+    PyObject_HEAD
+    MrdbResultHolder *holder;
+    char *data;
+    Py_ssize_t length;
+} MrdbBlobBuffer;
+
+/* Background reader for unbuffered result sets: A native thread reads
+   rows without holding the GIL and copies the raw values into a ring
+   of slots, which will be decoded by the cursor */
+typedef struct {
+    MrdbRawValue *raw;
+    unsigned char *data;
+    size_t data_size;
+} MrdbPrefetchSlot;
+
+typedef struct st_mrdb_prefetch {
+    MrdbCursor *cursor;
+    MrdbColumnPlan *plan;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty; /* row available or reader finished */
+    pthread_cond_t not_full;
+    MrdbPrefetchSlot *slots;
+    MrdbRawValue *current; /* raw values of the row read by the thread */
+    uint32_t field_count;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    uint8_t running;
+    uint8_t stop;
+    uint8_t eof;
+    uint8_t error; /* PREFETCH_ERROR_* */
+    uint8_t held; /* head slot is in use by the cursor */
+} MrdbPrefetch;
+
+#define PREFETCH_ERROR_NONE 0
+#define PREFETCH_ERROR_SERVER 1
+#define PREFETCH_ERROR_MEMORY 2
+
 typedef struct
 {
     PyObject_HEAD
@@ -370,13 +723,19 @@ extern PyObject *Mariadb_NotSupportedError;
 extern PyObject *Mariadb_Warning;
 
 extern PyObject *decimal_module,
-                *decimal_type;
+                *decimal_type,
+                *indicator_type;
 
 /* Object types */
 extern PyTypeObject MrdbPool_Type;
 extern PyTypeObject Mariadb_Fieldinfo_Type;
 extern PyTypeObject MrdbConnection_Type;
 extern PyTypeObject MrdbCursor_Type;
+extern PyTypeObject MrdbColumnPlan_Type;
+extern PyTypeObject MrdbRow_Type;
+extern PyTypeObject MrdbColumnBuffer_Type;
+extern PyTypeObject MrdbResultHolder_Type;
+extern PyTypeObject MrdbBlobBuffer_Type;
 
 PyObject *ListOrTuple_GetItem(PyObject *obj, Py_ssize_t index);
 int Mariadb_traverse(PyObject *self,
@@ -445,9 +804,62 @@ MrdbConnection_tpc_prepare(MrdbConnection *self);
 PyObject *
 MrdbConnection_tpc_recover(MrdbConnection *self);
 
+/* cursor prototypes */
+PyObject *
+MrdbCursor_FetchColumns(MrdbCursor *self, uint64_t row_count,
+                        uint8_t decimal128);
+
+PyObject *
+MrdbCursor_arrow_c_stream(MrdbCursor *self, PyObject *batch_rows);
+
+/* prefetch prototypes */
+uint8_t
+MrdbPrefetch_Start(MrdbCursor *self);
+
+void
+MrdbPrefetch_Stop(MrdbPrefetch *prefetch);
+
+void
+MrdbPrefetch_Free(MrdbCursor *self);
+
+uint8_t
+MrdbPrefetch_Fetch(MrdbCursor *self, int *rc);
+
+/* spool prototypes */
+uint8_t
+MrdbSpool_Load(MrdbCursor *self);
+
+int
+MrdbSpool_Fetch(MrdbCursor *self);
+
+void
+MrdbSpool_Free(MrdbCursor *self);
+
+/* blob prototypes */
+MrdbResultHolder *
+MrdbResultHolder_New(MrdbConnection *connection);
+
+void
+MrdbCursor_DetachResult(MrdbCursor *self);
+
+void
+MrdbConnection_ClosePendingStatements(MrdbConnection *self);
+
+PyObject *
+MrdbBlobBuffer_New(PyObject *holder, const unsigned char *data,
+                   unsigned long length);
+
 /* codecs prototypes  */
 uint8_t
-mariadb_check_bulk_parameters(MrdbCursor *self, PyObject *data);
+mariadb_bind_bulk_parameters(MrdbCursor *self, PyObject *data,
+                             Py_ssize_t offset, size_t max_bytes);
+
+uint8_t
+mariadb_bind_bulk_columns(MrdbCursor *self, PyObject *data,
+                          Py_ssize_t offset, size_t max_bytes);
+
+void
+mariadb_free_bulk_parameters(MrdbCursor *self);
 
 uint8_t
 mariadb_check_execute_parameters(MrdbCursor *self, PyObject *data);
@@ -455,6 +867,38 @@ mariadb_check_execute_parameters(MrdbCursor *self, PyObject *data);
 uint8_t
 mariadb_param_update(void *data, MYSQL_BIND *bind, uint32_t row_nr);
 
+uint8_t
+mariadb_init_column_plan(MrdbCursor *self);
+
+void
+mariadb_free_column_plan(MrdbCursor *self);
+
+PyObject *
+mariadb_decode_raw_value(MrdbColumnPlan *plan, uint32_t column,
+                         MrdbRawValue *raw);
+
+void
+field_fetch_callback(void *data, unsigned int column, unsigned char **row);
+
+void
+mariadb_prefetch_callback(void *data, unsigned int column,
+                          unsigned char **row);
+
+int
+Py_str_to_TIME(const char *str, size_t length, MYSQL_TIME *tm);
+
+/* row prototypes */
+PyObject *
+MrdbRow_New(MrdbColumnPlan *plan, MrdbRawValue *raw);
+
+/* column buffer prototypes */
+PyObject *
+MrdbColumnBuffer_New(MrdbColumnPlan *plan, uint32_t column,
+                     MYSQL_FIELD *field, uint8_t decimal128);
+
+uint8_t
+MrdbColumnBuffer_Append(MrdbColumnBuffer *self, MrdbRawValue *raw);
+
 /* parser prototypes */
 MrdbParser *
 MrdbParser_init(MYSQL *mysql, const char *statement, size_t length);
@@ -465,6 +909,9 @@ MrdbParser_end(MrdbParser *p);
 uint8_t
 MrdbParser_parse(MrdbParser *p, uint8_t is_batch, char *errmsg, size_t errmsg_len);
 
+uint8_t
+MrdbParser_get_row(MrdbParser *p, size_t *ofs, size_t *len);
+
 /* Global defines */
 
 
@@ -481,7 +928,11 @@ MrdbParser_parse(MrdbParser *p, uint8_t is_batch, char *errmsg, size_t errmsg_le
 /* Helper macros */
 
 #define MrdbIndicator_Check(a)\
-      (PyObject_HasAttrString(a, "indicator"))
+      (PyObject_TypeCheck((a), (PyTypeObject *)indicator_type))
+
+#define MRDB_BULK_SUPPORTED(connection)\
+      ((connection)->ext_capabilities &\
+       (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32))
 
 #define MARIADB_CHECK_CONNECTION(connection, ret)\
     if (!(connection) || !(connection)->mysql)\
@@ -489,7 +940,10 @@ MrdbParser_parse(MrdbParser *p, uint8_t is_batch, char *errmsg, size_t errmsg_le
         mariadb_throw_exception(NULL, Mariadb_InterfaceError, 0, \
            "Invalid connection or not connected");\
         return (ret);\
-    }
+    }\
+    /* the connection can't be used while a background reader is active */\
+    if ((connection)->prefetch)\
+        MrdbPrefetch_Stop((connection)->prefetch);
 
 #define MARIADB_CHECK_TPC(connection)\
   if (connection->tpc_state == TPC_STATE_NONE)\
@@ -5,12 +5,14 @@ MySQL databases, using an API which is compliant with the Python DB API 2.0
 '''
 import mariadb
 from ._mariadb import (
+    ColumnBuffer,
     DataError,
     DatabaseError,
     Error,
     IntegrityError,
     InterfaceError,
     InternalError,
+    LazyRow,
     NotSupportedError,
     OperationalError,
     PoolError,
@@ -132,6 +134,10 @@ def connect(*args, connectionclass=mariadb.connections.Connection, **kwargs):
         - converter:
             Specifies a conversion dictionary, where keys are FIELD_TYPE
             values and values are conversion functions
+        - decimal_format="decimal":
+            Specifies the representation of DECIMAL values: "decimal"
+            (decimal.Decimal), "str", "float" or "int" (value scaled by
+            10^scale of the column). Can be overwritten for a cursor.
 
     """
     if kwargs:
@@ -62,6 +62,8 @@ class Connection(mariadb._mariadb.connection):
         autocommit = kwargs.pop("autocommit", False)
         reconnect = kwargs.pop("reconnect", False)
         self._converter = kwargs.pop("converter", None)
+        self._decimal_format = mariadb.cursors._decimal_format(
+            kwargs.pop("decimal_format", "decimal"))
 
         # if host contains a connection string or multiple hosts,
         # we need to check if it's supported by Connector/C
@@ -102,6 +104,22 @@ class Connection(mariadb._mariadb.connection):
           Please note that the default was False for MariaDB Connector/Python
           versions < 1.1.0.
 
+        - prefetch = False
+          Unbuffered cursors only: If set to True (or to the number of rows
+          to buffer), rows will be read by a background thread, which
+          doesn't hold the GIL, while the application decodes and
+          processes previously read rows. If the buffer is full, the
+          background thread waits until rows were fetched.
+          Using the connection for other operations stops the background
+          thread.
+
+        - buffer_limit = 0
+          Buffered cursors only: Maximum size in bytes of the result set
+          kept in memory. If a result set exceeds this limit, the remaining
+          rows will be stored in a temporary file, which will be mapped
+          into memory. Scrolling and rowcount are not affected.
+          0 means no limit, the entire result set is stored in memory.
+
         - dictionary = False
           Return fetch values as dictionary.
 
@@ -110,10 +128,26 @@ class Connection(mariadb._mariadb.connection):
           compatibility reasons and should be avoided due to possible
           inconsistency.
 
+        - lazy = False
+          Return rows which convert column values only when they are
+          accessed. Columns can be accessed by index, slice or column name,
+          the materialize() method of the row returns all values as tuple.
+
         - cursor_type = CURSOR.NONE
           If cursor_type is set to CURSOR.READ_ONLY, a cursor is opened
           for the statement invoked with cursors execute() method.
 
+        - fetch_size = None
+          Number of rows an unbuffered cursor with cursor_type
+          CURSOR.READ_ONLY retrieves from the server per round trip.
+          If set to "auto", the number of rows will be doubled each time
+          all previously retrieved rows were fetched, as long as the
+          estimated size of the rows doesn't exceed fetch_buffer_size.
+
+        - fetch_buffer_size = 1048576
+          Maximum size in bytes of the rows retrieved per round trip if
+          fetch_size was set to "auto".
+
         - prepared = False
           When set to True cursor will remain in prepared state after the first
           execute() method was called. Further calls to execute() method will
@@ -122,6 +156,41 @@ class Connection(mariadb._mariadb.connection):
         - binary = False
           Always execute statement in MariaDB client/server binary protocol.
 
+        - decimal_format = None
+          Representation of DECIMAL values: "decimal" returns
+          decimal.Decimal objects, "str" returns strings, "float" returns
+          floats and "int" returns integers scaled by 10^scale of the column.
+          If not specified, the decimal_format of the connection will be used.
+
+        - max_fetch_bytes = 0
+          Default byte limit for fetchmany(): If set, fetchmany() stops
+          fetching rows after the raw size of the fetched column values
+          reached this limit. 0 means no limit.
+
+        - arrow_batch_size = 65536
+          Maximum number of rows per record batch when exporting a result
+          set via Arrow PyCapsule interface (cursor.__arrow_c_stream__).
+
+        - intern_strings = False
+          If set to True, identical short string values of a column will
+          share the same str object. This reduces memory usage for columns
+          with only a few distinct values. The cache will be disabled
+          automatically if the hit rate is too low. ENUM and SET columns
+          are always cached.
+
+        - blob_as_memoryview = False
+          Buffered cursors only: If set to True, values of BLOB, BINARY and
+          VARBINARY columns will be returned as read-only memoryview objects
+          referring to the result set instead of copies of the data. The
+          result set will be kept in memory until all memoryviews were
+          released. Not supported for server side cursors and lazy rows.
+
+        - stream_blobs = False
+          If set to True, values of BLOB and TEXT columns won't be decoded
+          when fetching a row: the row contains the length of the value in
+          bytes (or None for NULL values) and the value can be read from
+          the row buffer with cursor.open_blob().
+
         In versions prior to 1.1.0 results were unbuffered by default,
         which means before executing another statement with the same
         connection the entire result set must be fetched.
@@ -547,7 +616,7 @@ class Connection(mariadb._mariadb.connection):
         """
 
         self._check_closed()
-        return self._mariadb_get_info(INFO.EXTENDED_SERVER_CAPABILITIES)
+        return self._ext_capabilities
 
     @property
     def server_port(self):
@@ -19,6 +19,8 @@
 
 import mariadb
 import datetime
+import io
+import itertools
 from numbers import Number
 from mariadb.constants import CURSOR, STATUS, CAPABILITY, INDICATOR
 from typing import Sequence
@@ -32,6 +34,7 @@ ROWS_ALL = -1
 RESULT_TUPLE = 0
 RESULT_NAMEDTUPLE = 1
 RESULT_DICTIONARY = 2
+RESULT_LAZY = 3
 
 # Command types
 SQL_NONE = 0,
@@ -46,6 +49,196 @@ SQL_OTHER = 255
 
 ROWS_EOF = -1
 
+# Default number of rows read in advance by unbuffered cursors (prefetch)
+PREFETCH_ROWS = 1024
+
+# Default byte budget per COM_STMT_FETCH for fetch_size="auto"
+FETCH_BUFFER_SIZE = 1024 * 1024
+
+# Number of rows executemany() reads in advance from iterators
+BULK_ROWS = 10000
+
+# Maximum number of placeholders in a prepared statement
+MAX_PLACEHOLDERS = 65535
+
+# Representation of DECIMAL values
+DECIMAL_FORMAT = {"decimal": 0,
+                  "str": 1,
+                  "float": 2,
+                  "int": 3}
+
+
+def _decimal_format(value):
+    """
+    Internal use only.
+
+    Returns the internal value for the decimal_format option
+    """
+    try:
+        return DECIMAL_FORMAT[value]
+    except (KeyError, TypeError):
+        raise mariadb.ProgrammingError("Invalid decimal_format '%s', valid "
+                                       "values are %s" %
+                                       (value, ", ".join(DECIMAL_FORMAT)))
+
+
+def _is_columnar(parameters):
+    """
+    Internal use only.
+
+    Returns True if the parameters of executemany() were passed
+    column-wise as objects which support the buffer protocol.
+    """
+    if isinstance(parameters, dict):
+        return True
+    if not isinstance(parameters, (list, tuple)) or not parameters:
+        return False
+    column = parameters[0]
+    if isinstance(column, (tuple, list, dict)):
+        return False
+    if hasattr(column, "data") and hasattr(column, "mask"):
+        return True
+    try:
+        memoryview(column)
+    except TypeError:
+        return False
+    return True
+
+
+def _column_data(column):
+    """
+    Internal use only.
+
+    Returns a (values, null_mask) tuple for a column of columnar
+    executemany() data. Masked arrays (objects with data and mask
+    attributes like numpy.ma.MaskedArray) provide a null mask.
+    """
+    if not (hasattr(column, "data") and hasattr(column, "mask")):
+        return (column, None)
+    data = column.data
+    mask = column.mask
+    # scalar mask (e.g. numpy.ma.nomask) applies to all rows
+    if mask is not None and getattr(mask, "shape", None) == ():
+        mask = b"\x01" * len(memoryview(data)) if mask else None
+    return (data, mask)
+
+
+def _value_size(value):
+    """
+    Internal use only.
+
+    Returns the estimated size of a parameter value in a COM_STMT_EXECUTE
+    packet.
+    """
+    if value is None:
+        return 0
+    if isinstance(value, float):
+        return 8
+    if isinstance(value, int) and value.bit_length() < 64:
+        return 8
+    if isinstance(value, (datetime.date, datetime.time, datetime.timedelta)):
+        return 13
+    if isinstance(value, str):
+        length = len(value) if value.isascii() else len(value.encode())
+    elif isinstance(value, (bytes, bytearray)):
+        length = len(value)
+    elif isinstance(value, memoryview):
+        length = value.nbytes
+    elif isinstance(value, INDICATOR.MrdbIndicator):
+        return 0
+    else:
+        length = len(str(value))
+    # length encoded
+    return length + 9
+
+
+def _columns_to_rows(parameters):
+    """
+    Internal use only.
+
+    Converts columnar executemany() data into a list of rows
+    """
+    if isinstance(parameters, dict):
+        keys = list(parameters)
+        columns = parameters.values()
+    else:
+        keys = None
+        columns = parameters
+    values = []
+    for column in columns:
+        data, mask = _column_data(column)
+        data = memoryview(data).tolist()
+        if mask is not None:
+            mask = memoryview(mask).tolist()
+            if len(mask) != len(data):
+                raise mariadb.ProgrammingError("Null mask doesn't match the "
+                                               "column data")
+            data = [None if null else value
+                    for value, null in zip(data, mask)]
+        if values and len(data) != len(values[0]):
+            raise mariadb.ProgrammingError("All columns must contain the "
+                                           "same number of rows")
+        values.append(data)
+    if keys is None:
+        return list(zip(*values))
+    return [dict(zip(keys, row)) for row in zip(*values)]
+
+
+class BlobReader(io.RawIOBase):
+    """
+    Read-only binary file object for a BLOB or TEXT value of the current
+    row of a cursor, returned by Cursor.open_blob().
+
+    Data is copied directly from the row buffer into the buffer passed
+    to readinto(). The reader becomes invalid as soon as the cursor
+    fetches another row or the result set was released.
+    """
+
+    def __init__(self, cursor, column, length):
+        super().__init__()
+        self._cursor = cursor
+        self._column = column
+        self._serial = cursor._row_serial
+        self._position = 0
+        self.length = length
+
+    def _check_row(self):
+        if self.closed:
+            raise ValueError("I/O operation on closed blob reader")
+        if self._cursor._row_serial != self._serial:
+            raise mariadb.ProgrammingError("Blob reader is no longer valid, "
+                                           "cursor fetched another row")
+
+    def readable(self):
+        return True
+
+    def seekable(self):
+        return True
+
+    def readinto(self, buffer):
+        self._check_row()
+        count = self._cursor._read_blob(self._column, self._position,
+                                        buffer)
+        self._position += count
+        return count
+
+    def seek(self, offset: int, whence=io.SEEK_SET):
+        self._check_row()
+        if whence == io.SEEK_CUR:
+            offset += self._position
+        elif whence == io.SEEK_END:
+            offset += self.length
+        elif whence != io.SEEK_SET:
+            raise ValueError("Invalid whence value")
+        if offset < 0:
+            raise ValueError("Negative seek position %d" % offset)
+        self._position = offset
+        return offset
+
+    def tell(self):
+        self._check_row()
+        return self._position
+
 
 class Cursor(mariadb._mariadb.cursor):
     """
@@ -73,26 +266,62 @@ class Cursor(mariadb._mariadb.cursor):
         self._force_binary = None
         self._rowcount = 0
         self.buffered = True
+        self.arrow_batch_size = 65536
+        self.max_fetch_bytes = 0
         self._parseinfo = None
         self._data = None
 
         if not connection:
             raise mariadb.ProgrammingError("Invalid or no connection provided")
 
+        self._decimal_format = connection._decimal_format
+
         # parse keywords
         if kwargs:
-            rtype = kwargs.pop("named_tuple", False)
-            if rtype:
+            named_tuple = kwargs.pop("named_tuple", False)
+            dictionary = kwargs.pop("dictionary", False)
+            lazy = kwargs.pop("lazy", False)
+            if named_tuple:
                 self._resulttype = RESULT_NAMEDTUPLE
-            else:
-                rtype = kwargs.pop("dictionary", False)
-                if rtype:
-                    self._resulttype = RESULT_DICTIONARY
+            elif dictionary:
+                self._resulttype = RESULT_DICTIONARY
+            elif lazy:
+                self._resulttype = RESULT_LAZY
             buffered = kwargs.pop("buffered", True)
             self.buffered = buffered
+            prefetch = kwargs.pop("prefetch", False)
+            if prefetch is True:
+                prefetch = PREFETCH_ROWS
+            self._prefetch = int(prefetch)
             self._prepared = kwargs.pop("prepared", False)
             self._force_binary = kwargs.pop("binary", False)
             self._cursor_type = kwargs.pop("cursor_type", 0)
+            fetch_size = kwargs.pop("fetch_size", None)
+            fetch_buffer_size = kwargs.pop("fetch_buffer_size",
+                                           FETCH_BUFFER_SIZE)
+            if fetch_size == "auto":
+                self._fetch_buffer_size = fetch_buffer_size
+            elif fetch_size is not None:
+                if not isinstance(fetch_size, int) or fetch_size < 1:
+                    raise mariadb.ProgrammingError("fetch_size must be a "
+                                                   "positive integer or "
+                                                   "'auto'")
+                kwargs["prefetch_size"] = fetch_size
+            self._intern_strings = kwargs.pop("intern_strings", False)
+            self._blob_as_memoryview = kwargs.pop("blob_as_memoryview", False)
+            self._stream_blobs = kwargs.pop("stream_blobs", False)
+            buffer_limit = kwargs.pop("buffer_limit", 0)
+            if not isinstance(buffer_limit, int) or buffer_limit < 0:
+                raise mariadb.ProgrammingError("buffer_limit must be a "
+                                               "non-negative integer")
+            self._buffer_limit = buffer_limit
+            self.arrow_batch_size = kwargs.pop("arrow_batch_size",
+                                               self.arrow_batch_size)
+            self.max_fetch_bytes = kwargs.pop("max_fetch_bytes",
+                                              self.max_fetch_bytes)
+            if "decimal_format" in kwargs:
+                self._decimal_format = \
+                    _decimal_format(kwargs.pop("decimal_format"))
 
         # call initialization of main class
         super().__init__(connection, **kwargs)
@@ -327,10 +556,40 @@ class Cursor(mariadb._mariadb.cursor):
         If the SQL statement contains a RETURNING clause, executemany()
         returns a result set containing the values for columns listed in the
         RETURNING clause.
+
+        Instead of rows, parameters can also be passed column-wise as
+        sequence (or as dictionary for pyformat placeholders) of
+        one-dimensional numeric objects which support the buffer protocol,
+        e.g. array.array, memoryview or NumPy arrays. The data will be sent
+        directly from these buffers. NULL values can be specified by masked
+        arrays (objects with data and mask attributes like
+        numpy.ma.MaskedArray).
+
+        Rows can also be passed as iterator or generator, they will be
+        consumed in chunks of BULK_ROWS rows. If the server supports bulk
+        operations, the rows will be sent in requests which don't exceed
+        max_allowed_packet, rowcount contains the total number of affected
+        rows.
+
+        If the server doesn't support bulk operations, INSERT and REPLACE
+        statements will be rewritten into multi-row statements
+        (INSERT ... VALUES (...),(...)), other statements will be executed
+        for each row.
         """
         self.check_closed()
 
-        if not parameters or not len(parameters):
+        if parameters is None:
+            raise mariadb.ProgrammingError("No data provided")
+
+        columnar = _is_columnar(parameters)
+        if columnar or isinstance(parameters, (list, tuple)):
+            rows = None
+            chunk = parameters
+        else:
+            rows = iter(parameters)
+            chunk = list(itertools.islice(rows, BULK_ROWS))
+
+        if not chunk or not len(chunk):
             raise mariadb.ProgrammingError("No data provided")
 
         self.connection._last_executed_statement = statement
@@ -340,24 +599,131 @@ class Cursor(mariadb._mariadb.cursor):
             self._clear_result()
 
         # If the server doesn't support bulk operations, we need to emulate
-        # by looping
-        # TODO: insert/replace statements are not optimized yet
-        #       rowcount updating
-        if not (self.connection.extended_server_capabilities &
+        if not (self.connection._ext_capabilities &
                 (CAPABILITY.BULK_OPERATIONS >> 32)):
-            count = 0
-            for row in parameters:
+            if columnar:
+                chunk = _columns_to_rows(chunk)
+            self._execute_batch(statement,
+                                itertools.chain(chunk, rows or ()))
+            self.connection._last_executed_statement = statement
+            return
+
+        # parse statement
+        if columnar:
+            self._parse_execute(statement, chunk, is_bulk=True)
+            if self._paramstyle == PARAMSTYLE_PYFORMAT:
+                chunk = [chunk[key] for key in self._keys]
+            self._data = [_column_data(column) for column in chunk]
+        else:
+            self._parse_execute(statement, chunk[0], is_bulk=True)
+            self._data = chunk
+        self.is_text = False
+        self._rowcount = 0
+
+        # Send the data in requests which fit into max_allowed_packet.
+        # The statement will be prepared with the first request only.
+        # The result set of a RETURNING clause can't be split over
+        # several requests, so all rows will be sent in one request.
+        if self._returning:
+            if rows:
+                self._data.extend(rows)
+                rows = None
+            max_bytes = 0
+        else:
+            max_bytes = self.connection._get_max_allowed_packet()
+        total = None
+        offset = 0
+        count = 0
+        while True:
+            offset += self._execute_bulk(columnar, offset, max_bytes)
+            self._bulk = 1
+            count += self.rowcount
+            if total is None:
+                total = len(memoryview(self._data[0][0])) if columnar \
+                        else len(self._data)
+            if offset == total and rows:
+                self._data = list(itertools.islice(rows, BULK_ROWS))
+                offset = 0
+                total = len(self._data)
+            if offset == total:
+                break
+            self._reprepare = False
+        self._rowcount = count
+
+    def _execute_batch(self, statement, rows):
+        """
+        For internal use
+
+        Emulates executemany() if the server doesn't support bulk
+        operations: INSERT and REPLACE statements with a single row
+        constructor will be rewritten into multi-row statements, limited
+        by max_allowed_packet and the maximum number of placeholders.
+        Other statements (and statements of prepared cursors) will be
+        executed row by row.
+        """
+        first = next(rows)
+        self._parse_execute(statement, first)
+        parts = None if self._prepared else self._batch_parts()
+        count = 0
+
+        if not parts:
+            for row in itertools.chain((first,), rows):
                 self.execute(statement, row)
                 count += self.rowcount
             self._rowcount = count
-        else:
-            # parse statement
-            self._parse_execute(statement, parameters[0], is_bulk=True)
-            self._data = parameters
-            self.is_text = False
-            self._rowcount = 0
-            self._execute_bulk()
-            self._bulk = 1
+            return
+
+        prefix, values, suffix = parts
+        paramcount = self.paramcount
+        keys = self._keys if self._paramstyle == PARAMSTYLE_PYFORMAT else None
+        max_rows = MAX_PLACEHOLDERS // paramcount
+        # header, statement and null bitmap, type and value of each
+        # parameter
+        max_bytes = self.connection._get_max_allowed_packet() - \
+            len((prefix + suffix).encode()) - 64
+        row_size = len(values.encode()) + 1 + 3 * paramcount
+        batch = (0, None)
+        data = []
+        size = 0
+        n = 0
+
+        for row in itertools.chain((first,), rows):
+            if keys:
+                if not isinstance(row, dict):
+                    raise mariadb.ProgrammingError("Data argument must be "
+                                                   "Dictionary")
+                try:
+                    row = [row[key] for key in keys]
+                except KeyError as e:
+                    raise mariadb.ProgrammingError("Dictionary doesn't contain"
+                                                   " key '%s'" % e.args[0])
+            else:
+                if not isinstance(row, (tuple, list)):
+                    raise mariadb.ProgrammingError("Data argument must be "
+                                                   "Tuple or List")
+                if len(row) != paramcount:
+                    raise mariadb.ProgrammingError(
+                        "statement (%s) doesn't match the number of data "
+                        "elements (%s)." % (paramcount, len(row)))
+            value_size = row_size + sum(_value_size(value) for value in row)
+            if n == max_rows or (n and size + value_size > max_bytes):
+                # batches with the same number of rows reuse the
+                # prepared statement
+                if batch[0] != n:
+                    batch = (n, prefix + ",".join((values,) * n) + suffix)
+                self.execute(batch[1], data)
+                count += self.rowcount
+                data = []
+                size = 0
+                n = 0
+            data.extend(row)
+            size += value_size
+            n += 1
+
+        if batch[0] != n:
+            batch = (n, prefix + ",".join((values,) * n) + suffix)
+        self.execute(batch[1], data)
+        self._rowcount = count + self.rowcount
 
     def _fetch_row(self):
         """
@@ -407,7 +773,7 @@ class Cursor(mariadb._mariadb.cursor):
         row = self._fetch_row()
         return row
 
-    def fetchmany(self, size: int = 0):
+    def fetchmany(self, size: int = 0, max_bytes: int = None):
         """
         Fetch the next set of rows of a query result, returning a sequence
         of sequences (e.g. a list of tuples). An empty sequence is returned
@@ -420,31 +786,104 @@ class Cursor(mariadb._mariadb.cursor):
         If this is not possible due to the specified number of rows not being
         available, fewer rows may be returned.
 
+        If max_bytes (or the cursor's max_fetch_bytes attribute) was
+        specified, no further rows will be fetched after the raw size of
+        the fetched column values reached max_bytes. At least one row
+        will be returned. If a byte limit is in effect and size was not
+        specified, the number of rows is limited by max_bytes only.
+
         An exception will be raised if the previous call to execute() didn't
         produce a result set or execute() wasn't called before.
         """
         if not self.buffered:
             self.check_closed()
 
+        if max_bytes is None:
+            max_bytes = self.max_fetch_bytes
+
         if size == 0:
-            size = self.arraysize
+            size = ROWS_EOF if max_bytes else self.arraysize
 
+        if max_bytes:
+            return super().fetchrows(size, max_bytes)
         return super().fetchrows(size)
 
-    def fetchall(self):
+    def open_blob(self, column):
         """
-        Fetch all remaining rows of a query result, returning them as a
-        sequence of sequences (e.g. a list of tuples).
+        Return a read-only binary file object (mariadb.cursors.BlobReader)
+        for a BLOB or TEXT column of the last fetched row, or None if the
+        value is NULL. The column can be specified by index or name.
+
+        The reader supports read(), readinto() and seek(), so large values
+        can be processed in chunks (e.g. with shutil.copyfileobj()), which
+        are copied directly from the row buffer of the connector. The reader
+        is valid until the next row was fetched.
+
+        If the cursor was created with the stream_blobs option, BLOB and
+        TEXT values aren't decoded when fetching the row, otherwise the
+        fetched row contains a copy of the value.
+
+        Since the iterator of buffered cursors decodes rows in advance,
+        rows of a buffered cursor must be fetched with fetchone().
+        """
+        self.check_closed()
+
+        length = self._blob_length(column)
+        if length is None:
+            return None
+        return BlobReader(self, column, length)
+
+    def fetch_columns(self, size: int = None):
+        """
+        Fetch the next set of rows of a query result (or all remaining rows
+        if size is None) and return them column by column.
+
+        Returns a list with a mariadb.ColumnBuffer object for each column.
+        Column values are stored in contiguous buffers without creating
+        Python objects for single values: integers as int64 (unsigned
+        BIGINT as uint64), floating point values as double, dates as int32
+        days since 1970-01-01, datetime and timestamp values as int64
+        microseconds since 1970-01-01 00:00:00 and time values as int64
+        microseconds. All other values are stored as utf8 or binary data
+        with int64 offsets. NULL values (and zero dates) are marked in the
+        validity bitmap.
+
+        Column buffers support the buffer protocol, so they can be passed
+        to array libraries without copying (e.g.
+        numpy.frombuffer(column, dtype=numpy.int64)).
 
         An exception will be raised if the previous call to execute() didn't
         produce a result set or execute() wasn't called before.
         """
         if not self.buffered:
             self.check_closed()
-        return super().fetchrows(ROWS_EOF)
 
-    def __iter__(self):
-        return iter(self.fetchone, None)
+        if size is None:
+            size = ROWS_EOF
+
+        return super()._fetch_columns(size)
+
+    def __arrow_c_stream__(self, requested_schema=None):
+        """
+        Export the remaining rows of the result set as Arrow C stream
+        (Arrow PyCapsule interface), e.g. pyarrow.table(cursor) or
+        pyarrow.RecordBatchReader.from_stream(cursor).
+
+        Rows are fetched while the consumer reads the stream, each record
+        batch contains up to arrow_batch_size rows. Column types are mapped
+        to Arrow types: integer types to int64 (unsigned BIGINT to uint64),
+        FLOAT and DOUBLE to double, DECIMAL to decimal128 (or large_utf8 if
+        the precision exceeds 38 digits), DATE to date32, DATETIME and
+        TIMESTAMP to timestamp[us], TIME to duration[us], binary types
+        (BLOB, BINARY, ...) to large_binary and all other types (VARCHAR,
+        JSON, ...) to large_utf8.
+
+        The requested_schema parameter is not supported and will be ignored.
+        """
+        if not self.buffered:
+            self.check_closed()
+
+        return super()._arrow_c_stream(self.arrow_batch_size)
 
     def scroll(self, value: int, mode="relative"):
         """
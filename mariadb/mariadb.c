@@ -30,7 +30,8 @@ extern int connection_datetime_init(void);
 PyObject *decimal_module= NULL,
          *decimal_type= NULL,
          *socket_module= NULL,
-         *indicator_module= NULL;
+         *indicator_module= NULL,
+         *indicator_type= NULL;
 extern uint16_t max_pool_size;
 
 int
@@ -133,6 +134,13 @@ PyMODINIT_FUNC PyInit__mariadb(void)
         goto error;
     }
 
+    /* indicator variables are checked by type */
+    if (!(indicator_module= PyImport_ImportModule("mariadb.constants.INDICATOR")) ||
+        !(indicator_type= PyObject_GetAttrString(indicator_module, "MrdbIndicator")))
+    {
+        goto error;
+    }
+
     Py_SET_TYPE(&MrdbCursor_Type, &PyType_Type);
     if (PyType_Ready(&MrdbCursor_Type) == -1)
     {
@@ -140,6 +148,40 @@ PyMODINIT_FUNC PyInit__mariadb(void)
     }
     PyModule_AddObject(module, "cursor", (PyObject *)&MrdbCursor_Type);
 
+    Py_SET_TYPE(&MrdbColumnPlan_Type, &PyType_Type);
+    if (PyType_Ready(&MrdbColumnPlan_Type) == -1)
+    {
+        goto error;
+    }
+
+    Py_SET_TYPE(&MrdbRow_Type, &PyType_Type);
+    if (PyType_Ready(&MrdbRow_Type) == -1)
+    {
+        goto error;
+    }
+    Py_INCREF(&MrdbRow_Type);
+    PyModule_AddObject(module, "LazyRow", (PyObject *)&MrdbRow_Type);
+
+    Py_SET_TYPE(&MrdbColumnBuffer_Type, &PyType_Type);
+    if (PyType_Ready(&MrdbColumnBuffer_Type) == -1)
+    {
+        goto error;
+    }
+    Py_INCREF(&MrdbColumnBuffer_Type);
+    PyModule_AddObject(module, "ColumnBuffer", (PyObject *)&MrdbColumnBuffer_Type);
+
+    Py_SET_TYPE(&MrdbResultHolder_Type, &PyType_Type);
+    if (PyType_Ready(&MrdbResultHolder_Type) == -1)
+    {
+        goto error;
+    }
+
+    Py_SET_TYPE(&MrdbBlobBuffer_Type, &PyType_Type);
+    if (PyType_Ready(&MrdbBlobBuffer_Type) == -1)
+    {
+        goto error;
+    }
+
     /* optional (MariaDB specific) globals */
     PyModule_AddObject(module, "mariadbapi_version",
                        PyUnicode_FromString(mysql_get_client_info()));
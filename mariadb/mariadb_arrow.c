@@ -0,0 +1,480 @@
+/*****************************************************************************
+  Copyright (C) 2018-2020 Georg Richter and MariaDB Corporation AB
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+ ****************************************************************************/
+
+/* Arrow C stream export:
+   Record batches are built from column buffers (see mariadb_columns.c),
+   exported arrays keep a reference to their column buffer, so no data
+   needs to be copied. The stream and the release callbacks may be called
+   from threads which don't hold the GIL. */
+
+#include "mariadb_python.h"
+#include <errno.h>
+
+#define ARROW_STREAM_CAPSULE_NAME "arrow_array_stream"
+#define ARROW_ERROR_LENGTH 512
+
+typedef struct {
+    MrdbCursor *cursor;
+    MrdbColumnPlan *plan; /* plan of the exported result set */
+    uint64_t batch_rows;
+    char error[ARROW_ERROR_LENGTH];
+} MrdbArrowStream;
+
+/* private data of a column array */
+typedef struct {
+    PyObject *column;
+    const void *buffers[3];
+} MrdbArrowColumn;
+
+/* private data of a record batch (struct array) */
+typedef struct {
+    struct ArrowArray **children;
+    const void *buffers[1];
+} MrdbArrowBatch;
+
+/* private data of a schema */
+typedef struct {
+    char format[32];
+    char *name;
+} MrdbArrowField;
+
+static const char empty_buffer[8]= {0};
+
+/* {{{ mrdb_arrow_set_error
+   Saves the message of the current Python exception for get_last_error */
+static int
+mrdb_arrow_set_error(MrdbArrowStream *stream, const char *message)
+{
+    PyObject *type, *value, *traceback, *str= NULL;
+
+    if (message)
+    {
+        snprintf(stream->error, ARROW_ERROR_LENGTH, "%s", message);
+        return EINVAL;
+    }
+
+    PyErr_Fetch(&type, &value, &traceback);
+    if (value && (str= PyObject_Str(value)))
+        snprintf(stream->error, ARROW_ERROR_LENGTH, "%s",
+                 PyUnicode_AsUTF8(str) ? PyUnicode_AsUTF8(str) : "");
+    else
+        snprintf(stream->error, ARROW_ERROR_LENGTH, "Unknown error");
+    Py_XDECREF(str);
+    Py_XDECREF(type);
+    Py_XDECREF(value);
+    Py_XDECREF(traceback);
+    PyErr_Clear();
+    return EIO;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_check_stream
+   The cursor could have been closed or could have executed another
+   statement since the stream was created */
+static int
+mrdb_arrow_check_stream(MrdbArrowStream *stream)
+{
+    if (stream->cursor->closed || stream->cursor->plan != stream->plan)
+        return mrdb_arrow_set_error(stream, "Result set of cursor is not "
+                                            "available anymore");
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_format */
+static void
+mrdb_arrow_format(MrdbColumnBuffer *column, char *format, size_t length)
+{
+    switch (column->type) {
+        case COLUMN_BUFFER_INT64:
+            snprintf(format, length, "l");
+            break;
+        case COLUMN_BUFFER_UINT64:
+            snprintf(format, length, "L");
+            break;
+        case COLUMN_BUFFER_DOUBLE:
+            snprintf(format, length, "g");
+            break;
+        case COLUMN_BUFFER_DATE32:
+            snprintf(format, length, "tdD");
+            break;
+        case COLUMN_BUFFER_TIMESTAMP:
+            snprintf(format, length, "tsu:");
+            break;
+        case COLUMN_BUFFER_DURATION:
+            snprintf(format, length, "tDu");
+            break;
+        case COLUMN_BUFFER_DECIMAL128:
+            snprintf(format, length, "d:%u,%u", column->precision,
+                     column->scale);
+            break;
+        case COLUMN_BUFFER_BINARY:
+            /* binary with 64-bit offsets */
+            snprintf(format, length, "Z");
+            break;
+        default:
+            /* utf8 with 64-bit offsets */
+            snprintf(format, length, "U");
+            break;
+    }
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_release_schema */
+static void
+mrdb_arrow_release_schema(struct ArrowSchema *schema)
+{
+    MrdbArrowField *field= (MrdbArrowField *)schema->private_data;
+    int64_t i;
+
+    for (i=0; i < schema->n_children; i++)
+    {
+        if (schema->children[i]->release)
+            schema->children[i]->release(schema->children[i]);
+        PyMem_RawFree(schema->children[i]);
+    }
+    MARIADB_FREE_MEM(schema->children);
+    if (field)
+    {
+        MARIADB_FREE_MEM(field->name);
+        PyMem_RawFree(field);
+    }
+    schema->release= NULL;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_init_schema */
+static int
+mrdb_arrow_init_schema(struct ArrowSchema *schema, const char *format,
+                       const char *name, int64_t n_children)
+{
+    MrdbArrowField *field;
+
+    memset(schema, 0, sizeof(struct ArrowSchema));
+    if (!(field= (MrdbArrowField *)PyMem_RawCalloc(1, sizeof(MrdbArrowField))))
+        return ENOMEM;
+    schema->private_data= field;
+    schema->release= mrdb_arrow_release_schema;
+
+    snprintf(field->format, sizeof(field->format), "%s", format);
+    if (!(field->name= (char *)PyMem_RawMalloc(strlen(name) + 1)))
+        return ENOMEM;
+    strcpy(field->name, name);
+    schema->format= field->format;
+    schema->name= field->name;
+
+    if (n_children &&
+        !(schema->children= (struct ArrowSchema **)PyMem_RawCalloc(
+                                n_children, sizeof(struct ArrowSchema *))))
+        return ENOMEM;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_get_schema */
+static int
+mrdb_arrow_get_schema(struct ArrowArrayStream *arrow_stream,
+                      struct ArrowSchema *out)
+{
+    MrdbArrowStream *stream= (MrdbArrowStream *)arrow_stream->private_data;
+    MrdbCursor *cursor= stream->cursor;
+    PyGILState_STATE state= PyGILState_Ensure();
+    uint32_t i;
+    int rc;
+
+    if ((rc= mrdb_arrow_check_stream(stream)))
+        goto end;
+
+    if ((rc= mrdb_arrow_init_schema(out, "+s", "", cursor->field_count)))
+        goto error;
+
+    for (i=0; i < cursor->field_count; i++)
+    {
+        MrdbColumnBuffer *column;
+        char format[32];
+
+        if (!(column= (MrdbColumnBuffer *)MrdbColumnBuffer_New(stream->plan, i,
+                                              &cursor->fields[i], 1)))
+        {
+            out->release(out);
+            rc= mrdb_arrow_set_error(stream, NULL);
+            goto end;
+        }
+        mrdb_arrow_format(column, format, sizeof(format));
+        Py_DECREF(column);
+
+        if (!(out->children[i]= (struct ArrowSchema *)
+                 PyMem_RawMalloc(sizeof(struct ArrowSchema))))
+        {
+            rc= ENOMEM;
+            goto error;
+        }
+        out->n_children++;
+        if ((rc= mrdb_arrow_init_schema(out->children[i], format,
+                                        cursor->fields[i].name, 0)))
+            goto error;
+        out->children[i]->flags= ARROW_FLAG_NULLABLE;
+    }
+    goto end;
+error:
+    if (out->release)
+        out->release(out);
+    mrdb_arrow_set_error(stream, "Out of memory");
+end:
+    PyGILState_Release(state);
+    return rc;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_release_column */
+static void
+mrdb_arrow_release_column(struct ArrowArray *array)
+{
+    MrdbArrowColumn *column= (MrdbArrowColumn *)array->private_data;
+    PyGILState_STATE state= PyGILState_Ensure();
+
+    Py_XDECREF(column->column);
+    PyGILState_Release(state);
+    PyMem_RawFree(column);
+    array->release= NULL;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_release_batch */
+static void
+mrdb_arrow_release_batch(struct ArrowArray *array)
+{
+    MrdbArrowBatch *batch= (MrdbArrowBatch *)array->private_data;
+    int64_t i;
+
+    for (i=0; i < array->n_children; i++)
+    {
+        if (batch->children[i]->release)
+            batch->children[i]->release(batch->children[i]);
+        PyMem_RawFree(batch->children[i]);
+    }
+    MARIADB_FREE_MEM(batch->children);
+    PyMem_RawFree(batch);
+    array->release= NULL;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_export_column
+   Exports a column buffer as arrow array, the array keeps a reference
+   to the column buffer */
+static int
+mrdb_arrow_export_column(MrdbColumnBuffer *buffer, struct ArrowArray *array)
+{
+    MrdbArrowColumn *column;
+
+    memset(array, 0, sizeof(struct ArrowArray));
+    if (!(column= (MrdbArrowColumn *)PyMem_RawCalloc(1, sizeof(MrdbArrowColumn))))
+        return ENOMEM;
+
+    Py_INCREF(buffer);
+    column->column= (PyObject *)buffer;
+    column->buffers[0]= buffer->null_count ? buffer->validity : NULL;
+    column->buffers[1]= buffer->data ? (const void *)buffer->data : empty_buffer;
+
+    array->length= buffer->length;
+    array->null_count= buffer->null_count;
+    array->n_buffers= 2;
+    if (!buffer->item_size)
+    {
+        column->buffers[1]= buffer->offsets;
+        column->buffers[2]= buffer->data ? (const void *)buffer->data :
+                                           empty_buffer;
+        array->n_buffers= 3;
+    }
+    array->buffers= column->buffers;
+    array->private_data= column;
+    array->release= mrdb_arrow_release_column;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_arrow_get_next
+   Fetches the next batch_rows rows and exports them as struct array */
+static int
+mrdb_arrow_get_next(struct ArrowArrayStream *arrow_stream,
+                    struct ArrowArray *out)
+{
+    MrdbArrowStream *stream= (MrdbArrowStream *)arrow_stream->private_data;
+    PyGILState_STATE state= PyGILState_Ensure();
+    PyObject *columns= NULL;
+    MrdbArrowBatch *batch;
+    Py_ssize_t i, count;
+    int rc;
+
+    memset(out, 0, sizeof(struct ArrowArray));
+
+    if ((rc= mrdb_arrow_check_stream(stream)))
+        goto end;
+
+    if (!(columns= MrdbCursor_FetchColumns(stream->cursor, stream->batch_rows,
+                                           1)))
+    {
+        rc= mrdb_arrow_set_error(stream, NULL);
+        goto end;
+    }
+
+    count= PyList_GET_SIZE(columns);
+    /* end of stream */
+    if (!count || !((MrdbColumnBuffer *)PyList_GET_ITEM(columns, 0))->length)
+        goto end;
+
+    if (!(batch= (MrdbArrowBatch *)PyMem_RawCalloc(1, sizeof(MrdbArrowBatch))))
+        goto oom;
+    out->length= ((MrdbColumnBuffer *)PyList_GET_ITEM(columns, 0))->length;
+    out->n_buffers= 1;
+    out->buffers= batch->buffers;
+    out->private_data= batch;
+    out->release= mrdb_arrow_release_batch;
+
+    if (!(batch->children= (struct ArrowArray **)PyMem_RawCalloc(count,
+                              sizeof(struct ArrowArray *))))
+        goto oom;
+    out->children= batch->children;
+
+    for (i=0; i < count; i++)
+    {
+        if (!(batch->children[i]= (struct ArrowArray *)
+                 PyMem_RawMalloc(sizeof(struct ArrowArray))))
+            goto oom;
+        out->n_children++;
+        if (mrdb_arrow_export_column(
+                (MrdbColumnBuffer *)PyList_GET_ITEM(columns, i),
+                batch->children[i]))
+            goto oom;
+    }
+    goto end;
+oom:
+    if (out->release)
+        out->release(out);
+    mrdb_arrow_set_error(stream, "Out of memory");
+    rc= ENOMEM;
+end:
+    Py_XDECREF(columns);
+    PyGILState_Release(state);
+    return rc;
+}
+/* }}} */
+
+static const char *
+mrdb_arrow_get_last_error(struct ArrowArrayStream *arrow_stream)
+{
+    MrdbArrowStream *stream= (MrdbArrowStream *)arrow_stream->private_data;
+
+    return stream->error[0] ? stream->error : NULL;
+}
+
+/* {{{ mrdb_arrow_release_stream */
+static void
+mrdb_arrow_release_stream(struct ArrowArrayStream *arrow_stream)
+{
+    MrdbArrowStream *stream= (MrdbArrowStream *)arrow_stream->private_data;
+    PyGILState_STATE state= PyGILState_Ensure();
+
+    Py_XDECREF(stream->plan);
+    Py_XDECREF(stream->cursor);
+    PyGILState_Release(state);
+    PyMem_RawFree(stream);
+    arrow_stream->release= NULL;
+}
+/* }}} */
+
+static void
+mrdb_arrow_stream_capsule_free(PyObject *capsule)
+{
+    struct ArrowArrayStream *arrow_stream= (struct ArrowArrayStream *)
+        PyCapsule_GetPointer(capsule, ARROW_STREAM_CAPSULE_NAME);
+
+    if (!arrow_stream)
+        return;
+    /* release callback was set to NULL if the consumer moved the stream */
+    if (arrow_stream->release)
+        arrow_stream->release(arrow_stream);
+    PyMem_RawFree(arrow_stream);
+}
+
+/* {{{ MrdbCursor_arrow_c_stream
+   Exports the current result set as Arrow C stream (PyCapsule), each
+   record batch contains up to batch_rows rows */
+PyObject *
+MrdbCursor_arrow_c_stream(MrdbCursor *self, PyObject *batch_rows)
+{
+    struct ArrowArrayStream *arrow_stream;
+    MrdbArrowStream *stream;
+    PyObject *capsule;
+    long long rows;
+
+    if (!CHECK_TYPE_NO_NONE(batch_rows, &PyLong_Type)) {
+        PyErr_SetString(PyExc_TypeError, "Parameter must be an integer value");
+        return NULL;
+    }
+    if ((rows= PyLong_AsLongLong(batch_rows)) <= 0)
+    {
+        if (!PyErr_Occurred())
+            mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                    "Number of rows per batch must be greater than zero");
+        return NULL;
+    }
+
+    MARIADB_CHECK_STMT_FETCH(self);
+    if (PyErr_Occurred())
+        return NULL;
+
+    if (!self->field_count || !self->plan)
+    {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Cursor doesn't have a result set");
+        return NULL;
+    }
+
+    if (!(arrow_stream= (struct ArrowArrayStream *)PyMem_RawCalloc(1,
+                            sizeof(struct ArrowArrayStream))) ||
+        !(stream= (MrdbArrowStream *)PyMem_RawCalloc(1,
+                      sizeof(MrdbArrowStream))))
+    {
+        MARIADB_FREE_MEM(arrow_stream);
+        return PyErr_NoMemory();
+    }
+
+    Py_INCREF(self);
+    stream->cursor= self;
+    Py_INCREF(self->plan);
+    stream->plan= self->plan;
+    stream->batch_rows= (uint64_t)rows;
+
+    arrow_stream->get_schema= mrdb_arrow_get_schema;
+    arrow_stream->get_next= mrdb_arrow_get_next;
+    arrow_stream->get_last_error= mrdb_arrow_get_last_error;
+    arrow_stream->release= mrdb_arrow_release_stream;
+    arrow_stream->private_data= stream;
+
+    if (!(capsule= PyCapsule_New(arrow_stream, ARROW_STREAM_CAPSULE_NAME,
+                                 mrdb_arrow_stream_capsule_free)))
+    {
+        arrow_stream->release(arrow_stream);
+        PyMem_RawFree(arrow_stream);
+        return NULL;
+    }
+    return capsule;
+}
+/* }}} */
@@ -0,0 +1,201 @@
+/*****************************************************************************
+  Copyright (C) 2018-2020 Georg Richter and MariaDB Corporation AB
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+ ****************************************************************************/
+#include "mariadb_python.h"
+
+/* {{{ MrdbResultHolder_New */
+MrdbResultHolder *
+MrdbResultHolder_New(MrdbConnection *connection)
+{
+    MrdbResultHolder *self;
+
+    if (!(self= PyObject_New(MrdbResultHolder, &MrdbResultHolder_Type)))
+        return NULL;
+    Py_INCREF(connection);
+    self->connection= connection;
+    self->stmt= NULL;
+    self->result= NULL;
+    return self;
+}
+/* }}} */
+
+/* {{{ MrdbConnection_ClosePendingStatements
+   Closes the statement handles of released result holders. Closing a
+   statement handle sends COM_STMT_CLOSE and drains a pending unbuffered
+   result, so this is deferred until the connection is idle: before the
+   next command, on cursor close or after the connection was closed. */
+void
+MrdbConnection_ClosePendingStatements(MrdbConnection *self)
+{
+    uint32_t i;
+
+    if (!self->pending_stmt_count)
+        return;
+
+    /* connection is in use by a result set of another cursor */
+    if (self->mysql &&
+        (self->prefetch || self->mysql->status != MYSQL_STATUS_READY))
+        return;
+
+    MARIADB_BEGIN_ALLOW_THREADS(self);
+    for (i= 0; i < self->pending_stmt_count; i++)
+        mysql_stmt_close(self->pending_stmts[i]);
+    MARIADB_END_ALLOW_THREADS(self);
+    self->pending_stmt_count= 0;
+}
+/* }}} */
+
+/* {{{ MrdbResultHolder_dealloc
+   Called after the last memoryview was released: frees the result set
+   or queues the statement handle which was handed over by the cursor.
+   This might happen at any decref, so the connection must not be used
+   here. */
+static void
+MrdbResultHolder_dealloc(MrdbResultHolder *self)
+{
+    MrdbConnection *connection= self->connection;
+
+    if (self->result)
+        mysql_free_result(self->result);
+    if (self->stmt)
+    {
+        if (connection->mysql &&
+            connection->pending_stmt_count == connection->pending_stmt_size)
+        {
+            uint32_t size= connection->pending_stmt_size ?
+                           connection->pending_stmt_size * 2 : 8;
+            MYSQL_STMT **stmts= PyMem_RawRealloc(connection->pending_stmts,
+                                                 size * sizeof(MYSQL_STMT *));
+            if (stmts)
+            {
+                connection->pending_stmts= stmts;
+                connection->pending_stmt_size= size;
+            }
+        }
+        if (connection->mysql &&
+            connection->pending_stmt_count < connection->pending_stmt_size)
+            connection->pending_stmts[connection->pending_stmt_count++]= self->stmt;
+        else
+            /* connection was closed and the handle was invalidated:
+               mysql_stmt_close only releases memory */
+            mysql_stmt_close(self->stmt);
+    }
+    Py_XDECREF(connection);
+    PyObject_Del(self);
+}
+/* }}} */
+
+PyTypeObject MrdbResultHolder_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mariadb.resultholder",
+    .tp_basicsize= (Py_ssize_t)sizeof(MrdbResultHolder),
+    .tp_dealloc= (destructor)MrdbResultHolder_dealloc,
+    .tp_flags= Py_TPFLAGS_DEFAULT,
+};
+
+/* {{{ MrdbCursor_DetachResult
+   Releases the result holder of the cursor. If memoryviews of the
+   current result set are still referenced, the result (text protocol)
+   or the statement handle (binary protocol) will be handed over to
+   the holder. In the latter case the cursor will initialize and prepare
+   a new statement handle on next execution.
+   Must be called before the result set of the cursor will be freed. */
+void
+MrdbCursor_DetachResult(MrdbCursor *self)
+{
+    MrdbResultHolder *holder= self->result_holder;
+    uint32_t i;
+
+    if (!holder)
+        return;
+
+    self->result_holder= NULL;
+    if (self->plan)
+    {
+        for (i= 0; i < self->plan->column_count; i++)
+            self->plan->columns[i].owner= NULL;
+    }
+
+    if (Py_REFCNT(holder) > 1)
+    {
+        if (self->parseinfo.is_text)
+        {
+            holder->result= self->result;
+            self->result= NULL;
+        } else {
+            holder->stmt= self->stmt;
+            self->stmt= NULL;
+        }
+    }
+    Py_DECREF(holder);
+}
+/* }}} */
+
+/* {{{ MrdbBlobBuffer_New
+   Returns a buffer object which exports the column data of a held
+   result set */
+PyObject *
+MrdbBlobBuffer_New(PyObject *holder, const unsigned char *data,
+                   unsigned long length)
+{
+    MrdbBlobBuffer *self;
+
+    if (!(self= PyObject_New(MrdbBlobBuffer, &MrdbBlobBuffer_Type)))
+        return NULL;
+    Py_INCREF(holder);
+    self->holder= (MrdbResultHolder *)holder;
+    self->data= (char *)data;
+    self->length= (Py_ssize_t)length;
+    return (PyObject *)self;
+}
+/* }}} */
+
+/* {{{ MrdbBlobBuffer_dealloc */
+static void
+MrdbBlobBuffer_dealloc(MrdbBlobBuffer *self)
+{
+    Py_XDECREF(self->holder);
+    PyObject_Del(self);
+}
+/* }}} */
+
+/* {{{ MrdbBlobBuffer_getbuffer */
+static int
+MrdbBlobBuffer_getbuffer(MrdbBlobBuffer *self, Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *)self,
+                             self->data ? self->data : (void *)"",
+                             self->length, 1, flags);
+}
+/* }}} */
+
+static PyBufferProcs MrdbBlobBuffer_as_buffer=
+{
+    .bf_getbuffer= (getbufferproc)MrdbBlobBuffer_getbuffer,
+};
+
+PyTypeObject MrdbBlobBuffer_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mariadb.blobbuffer",
+    .tp_basicsize= (Py_ssize_t)sizeof(MrdbBlobBuffer),
+    .tp_dealloc= (destructor)MrdbBlobBuffer_dealloc,
+    .tp_as_buffer= &MrdbBlobBuffer_as_buffer,
+    .tp_flags= Py_TPFLAGS_DEFAULT,
+};
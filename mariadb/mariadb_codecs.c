@@ -19,15 +19,30 @@
 #include "mariadb_python.h"
 #include <datetime.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MRDB_HAVE_SSE2
+#endif
+
 #define CHARSET_BINARY 63
 
-#define IS_DECIMAL_TYPE(type) \
-((type) == MYSQL_TYPE_NEWDECIMAL || (type) == MYSQL_TYPE_DOUBLE || (type) == MYSQL_TYPE_FLOAT)
+/* 65 digits, sign, decimal point and fraction digits for scaled integers */
+#define MAX_DECIMAL_BUFSIZE 128
 
 long MrdbIndicator_AsLong(PyObject *column)
 {
   PyObject *pyLong= PyObject_GetAttrString(column, "indicator");
-  return PyLong_AsLong(pyLong);
+  long indicator;
+
+  if (!pyLong)
+    return -1;
+  indicator= PyLong_AsLong(pyLong);
+  Py_DECREF(pyLong);
+  return indicator;
 }
 
 int codecs_datetime_init(void)
@@ -432,452 +447,1309 @@ static PyObject *Mrdb_GetTimeDelta(MYSQL_TIME *tm)
     return PyDelta_FromDSU(days, second, second_part);
 }
 
-static PyObject *ma_convert_value(MrdbCursor *self,
-                                  enum enum_field_types type,
-                                  PyObject *value)
+/* {{{ ma_get_converter
+   Returns a new reference to the callable which was registered in
+   the connection's conversion dictionary for the given field type,
+   or NULL if there is none */
+static PyObject *ma_get_converter(MrdbCursor *self,
+                                  enum enum_field_types type)
 {
-    PyObject *key= PyLong_FromLongLong(type);
-    PyObject *func;
-    PyObject *new_value= NULL;
+    PyObject *key, *func;
 
-    if (!self->connection->converter)
+    if (!self->connection->converter ||
+        !PyDict_Check(self->connection->converter))
         return NULL;
 
-    if ((func= PyDict_GetItem(self->connection->converter, key)) &&
-            PyCallable_Check(func))
+    if (!(key= PyLong_FromLongLong(type)))
     {
-        PyObject *arglist= PyTuple_New(1);
-        PyTuple_SetItem(arglist, 0, value);
-        new_value= PyObject_CallObject(func, arglist);
+        PyErr_Clear();
+        return NULL;
     }
+    func= PyDict_GetItem(self->connection->converter, key);
+    Py_DECREF(key);
+
+    if (!func || !PyCallable_Check(func))
+        return NULL;
+    Py_INCREF(func);
+    return func;
+}
+/* }}} */
+
+/* {{{ ma_convert_value
+   Passes the decoded value to the column's converter. The reference
+   to value is consumed, returns a new reference or NULL on error */
+static PyObject *ma_convert_value(MrdbColumn *column,
+                                  PyObject *value)
+{
+    PyObject *new_value;
+
+    new_value= PyObject_Vectorcall(column->converter, &value, 1, NULL);
+    Py_DECREF(value);
     return new_value;
 }
+/* }}} */
  
-void
-field_fetch_fromtext(MrdbCursor *self, char *data, unsigned int column)
+/* {{{ column decoders
+   Decoders for binary protocol read the value from the row buffer and
+   advance the row pointer, decoders for text protocol get the column data
+   and its length. All decoders return a new reference. */
+static PyObject *
+mrdb_decode_none(MrdbColumn *column, unsigned char **row, unsigned long length)
 {
-    MYSQL_TIME tm;
-    unsigned long *length;
-    Mrdb_ExtFieldType *ext_field_type;
-    uint16_t type= self->fields[column].type;
+    Py_RETURN_NONE;
+}
 
-    ext_field_type= mariadb_extended_field_type(&self->fields[column]);
+static PyObject *
+mrdb_decode_bin_tiny(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromLong((long)(int8_t)*row[0]);
+    *row+= 1;
+    return obj;
+}
 
-    if (!data)
-      type= MYSQL_TYPE_NULL;
+static PyObject *
+mrdb_decode_bin_utiny(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromUnsignedLong((unsigned long)*row[0]);
+    *row+= 1;
+    return obj;
+}
 
-    length= mysql_fetch_lengths(self->result);
+static PyObject *
+mrdb_decode_bin_short(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromLong((long)sint2korr(*row));
+    *row+= 2;
+    return obj;
+}
 
-    switch (type)
-    {
-        case MYSQL_TYPE_NULL:
-            Py_INCREF(Py_None);
-            self->values[column]= Py_None;
-            break;
-        case MYSQL_TYPE_TINY:
-        case MYSQL_TYPE_SHORT:
-        case MYSQL_TYPE_YEAR:
-        case MYSQL_TYPE_INT24:
-        case MYSQL_TYPE_LONG:
-        case MYSQL_TYPE_LONGLONG:
-        {
-            char *p= data;
+static PyObject *
+mrdb_decode_bin_ushort(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromUnsignedLong((unsigned long)uint2korr(*row));
+    *row+= 2;
+    return obj;
+}
 
-            /* CONPY-258: remove leading zero's */
-            if (strlen(p) > 1)
-            {
-                while (*p && *p == '0')
-                p++;
-            }
-            self->values[column]= PyLong_FromString(p, NULL, 0);
-            break;
-        }
-        case MYSQL_TYPE_FLOAT:  
-        case MYSQL_TYPE_DOUBLE: 
-        {
-            double d= atof(data);
-            self->values[column]= PyFloat_FromDouble(d);
-            break;
-        }
-        case MYSQL_TYPE_TIME:
-        case MYSQL_TYPE_DATE:
-        case MYSQL_TYPE_DATETIME:
-        case MYSQL_TYPE_TIMESTAMP:
-            memset(&tm, 0, sizeof(MYSQL_TIME));
-            Py_str_to_TIME(data, strlen(data), &tm);
-            if (self->fields[column].type == MYSQL_TYPE_TIME)
-            {
-                if (check_time(&tm))
-                {
-                      self->values[column]= Mrdb_GetTimeDelta(&tm);
-                }
-                else {
-                    Py_INCREF(Py_None);
-                    self->values[column]= Py_None;
-                }
-            } else if (self->fields[column].type == MYSQL_TYPE_DATE)
-            {
-                if (check_date(tm.year, tm.month, tm.day))
-                {
-                    self->values[column]= PyDate_FromDate(tm.year, tm.month, tm.day);
-                }
-                else {
-                    Py_INCREF(Py_None);
-                    self->values[column]= Py_None;
-                }
-            } else 
-            {
-                if (check_date(tm.year, tm.month, tm.day) &&
-                    check_time(&tm))
-                {
-                    self->values[column]= PyDateTime_FromDateAndTime(tm.year, tm.month,
-                               tm.day, tm.hour, tm.minute, tm.second, tm.second_part);
-                }
-                else {
-                    Py_INCREF(Py_None);
-                    self->values[column]= Py_None;
-                }
-            }
-            break;
-        case MYSQL_TYPE_TINY_BLOB:
-        case MYSQL_TYPE_MEDIUM_BLOB:
-        case MYSQL_TYPE_BLOB:
-        case MYSQL_TYPE_LONG_BLOB:
-        case MYSQL_TYPE_GEOMETRY:
-        case MYSQL_TYPE_BIT:
-            if (length[column] > self->fields[column].max_length)
-            {
-                self->fields[column].max_length= length[column];
-            }
-            if (self->fields[column].charsetnr== CHARSET_BINARY)
-            {
-                self->values[column]= 
-                       PyBytes_FromStringAndSize((const char *)data,
-                                                 (Py_ssize_t)length[column]);
-            }
-            else {
-                self->values[column]= 
-                    PyUnicode_FromStringAndSize((const char *)data, 
-                                                (Py_ssize_t)length[column]);
-            }
-            break;
-        case MYSQL_TYPE_NEWDECIMAL:
-        {
-            PyObject *decimal;
-            decimal= PyObject_CallFunction(decimal_type, "s", (const char *)data);
-            self->values[column]= decimal;
-            break;
-        }
-        case MYSQL_TYPE_STRING:
-        case MYSQL_TYPE_VAR_STRING:
-        case MYSQL_TYPE_JSON:
-        case MYSQL_TYPE_VARCHAR:
-        case MYSQL_TYPE_DECIMAL:
-        case MYSQL_TYPE_SET:
-        case MYSQL_TYPE_ENUM:
-        {
-            unsigned long len;
-            if ( self->fields[column].charsetnr == CHARSET_BINARY)
-            {
-                self->values[column]=
-                        PyBytes_FromStringAndSize((const char *)data,
-                                                       (Py_ssize_t)length[column]);
-                len= (unsigned long)length[column];
-            } else {
-                self->values[column]=
-                    PyUnicode_FromStringAndSize((const char *)data,
-                                                (Py_ssize_t)length[column]);
-                len= (unsigned long)PyUnicode_GET_LENGTH(self->values[column]);
-            }
-            if (len > self->fields[column].max_length)
-            {
-                self->fields[column].max_length= len;
-            }
-            break;
-        }
-        default:
-            break;
-    }
-        /* check if values need to be converted */
-    if (self->connection->converter)
-    {
-        PyObject *val;
-        enum enum_field_types type;
+static PyObject *
+mrdb_decode_bin_int24(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromLong((long)sint3korr(*row));
+    *row+= 4;
+    return obj;
+}
 
-        if (ext_field_type && ext_field_type->ext_type == EXT_TYPE_JSON)
-          type= MYSQL_TYPE_JSON;
-        else
-          type= self->fields[column].type;
+static PyObject *
+mrdb_decode_bin_uint24(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromUnsignedLong((unsigned long)uint3korr(*row));
+    *row+= 4;
+    return obj;
+}
 
-        if ((val= ma_convert_value(self, type, self->values[column])))
-            self->values[column]= val;
-    }
-} 
+static PyObject *
+mrdb_decode_bin_long(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromLong((long)sint4korr(*row));
+    *row+= 4;
+    return obj;
+}
 
-/* field_fetch_callback
-   This function was previously registered with mysql_stmt_attr_set and
-   STMT_ATTR_FIELD_FETCH_CALLBACK parameter. Instead of filling a bind 
-   buffer MariaDB Connector/C sends raw data in row for the specified column.
-   In case of a NULL value row ptr will be NULL.
+static PyObject *
+mrdb_decode_bin_ulong(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromUnsignedLong((unsigned long)uint4korr(*row));
+    *row+= 4;
+    return obj;
+}
 
-   The cursor handle was also previously registered with mysql_stmt_attr_set
-   and STMT_ATTR_USER_DATA parameter and will be passed in data variable.
-*/
+static PyObject *
+mrdb_decode_bin_longlong(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj= PyLong_FromLongLong((long long)sint8korr(*row));
+    *row+= 8;
+    return obj;
+}
 
-void
-field_fetch_callback(void *data, unsigned int column, unsigned char **row)
+static PyObject *
+mrdb_decode_bin_ulonglong(MrdbColumn *column, unsigned char **row, unsigned long length)
 {
-    MrdbCursor *self= (MrdbCursor *)data;
-    Mrdb_ExtFieldType *ext_field_type;
+    PyObject *obj= PyLong_FromUnsignedLongLong((unsigned long long)sint8korr(*row));
+    *row+= 8;
+    return obj;
+}
 
-    ext_field_type= mariadb_extended_field_type(&self->fields[column]);
+static PyObject *
+mrdb_decode_bin_float(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    float f;
 
-    if (!row)
-    {
-        Py_INCREF(Py_None);
-        self->values[column]= Py_None;
+    float4get(f, *row);
+    *row+= 4;
+    return PyFloat_FromDouble((double)f);
+}
+
+static PyObject *
+mrdb_decode_bin_double(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    double d;
+
+    float8get(d, *row);
+    *row+= 8;
+    return PyFloat_FromDouble(d);
+}
+
+/* {{{ mrdb_temporal_cache_free */
+static void
+mrdb_temporal_cache_free(MrdbColumn *column)
+{
+    uint32_t i;
+
+    if (!column->temporal_cache)
         return;
+    for (i=0; i < MRDB_TEMPORAL_CACHE_SLOTS; i++)
+    {
+        Py_XDECREF(column->temporal_cache->entries[i].value);
+    }
+    MARIADB_FREE_MEM(column->temporal_cache);
+}
+/* }}} */
+
+/* {{{ mrdb_new_temporal
+   Returns a date (is_date= 1) or datetime object. Values are cached per
+   column, so repeated values share the same object. If the hit rate is
+   too low, the cache will be released. */
+static PyObject *
+mrdb_new_temporal(MrdbColumn *column, uint8_t is_date,
+                  int year, int month, int day,
+                  int hour, int minute, int second, int second_part)
+{
+    MrdbTemporalCache *cache= column->temporal_cache;
+    MrdbTemporalCacheEntry *entry= NULL;
+    PyObject *obj;
+    uint64_t key= 0;
+
+    if (cache &&
+        year >= 0 && year <= 9999 && month >= 0 && month <= 12 &&
+        day >= 0 && day <= 31 && hour >= 0 && hour <= 23 &&
+        minute >= 0 && minute <= 59 && second >= 0 && second <= 59 &&
+        second_part >= 0 && second_part <= 999999)
+    {
+        /* 14 bits year, 4 bits month, 5 bits day, 5 bits hour, 6 bits
+           minute, 6 bits second and 20 bits microseconds. The highest
+           bit marks the entry as used */
+        key= (1ULL << 63) | ((uint64_t)year << 46) | ((uint64_t)month << 42) |
+             ((uint64_t)day << 37) | ((uint64_t)hour << 32) |
+             ((uint64_t)minute << 26) | ((uint64_t)second << 20) |
+             (uint64_t)second_part;
+        entry= &cache->entries[((key * 0x9E3779B97F4A7C15ULL) >> 32) &
+                                (MRDB_TEMPORAL_CACHE_SLOTS - 1)];
+        cache->lookups++;
+        if (entry->key == key)
+        {
+            cache->hits++;
+            Py_INCREF(entry->value);
+            return entry->value;
+        }
     }
-    switch(self->fields[column].type) {
-        case MYSQL_TYPE_NULL:
-            Py_INCREF(Py_None);
-            self->values[column]= Py_None;
-            break;
-        case MYSQL_TYPE_TINY:
-            self->values[column]= (self->fields[column].flags &
-                 UNSIGNED_FLAG) ?
-                PyLong_FromUnsignedLong((unsigned long)*row[0]) :
-                PyLong_FromLong((long)*row[0]);
-            *row+= 1;
-            break;
-        case MYSQL_TYPE_SHORT:
-        case MYSQL_TYPE_YEAR:
-            self->values[column]=
-                (self->fields[column].flags & UNSIGNED_FLAG) ?
-                PyLong_FromUnsignedLong((unsigned long)uint2korr(*row)) :
-                PyLong_FromLong((long)sint2korr(*row));
-            *row+= 2;
-            break;
-        case MYSQL_TYPE_INT24:
-            self->values[column]= 
-                (self->fields[column].flags & UNSIGNED_FLAG) ?
-                PyLong_FromUnsignedLong((unsigned long)uint3korr(*row)) :
-                PyLong_FromLong((long)sint3korr(*row));
-            *row+= 4;
-            break;
-        case MYSQL_TYPE_LONG:
-            self->values[column]=
-                (self->fields[column].flags & UNSIGNED_FLAG) ?
-                PyLong_FromUnsignedLong((unsigned long)uint4korr(*row)) :
-                PyLong_FromLong((long)sint4korr(*row));
-            *row+= 4;
-            break;
-        case MYSQL_TYPE_LONGLONG:
-            {
-                long long l= sint8korr(*row);
-                self->values[column]=
-                   (self->fields[column].flags & UNSIGNED_FLAG) ?
-                    PyLong_FromUnsignedLongLong((unsigned long long)l) :
-                    PyLong_FromLongLong(l);
-                *row+= 8;
-                break;
-            }
-        case MYSQL_TYPE_FLOAT:
-            {
-                float f;
-                float4get(f, *row);
-                self->values[column]= PyFloat_FromDouble((double)f);
-                *row+= 4;
-                break;
-            }
-        case MYSQL_TYPE_DOUBLE:
-            {
-                double d;
-                float8get(d, *row);
-                self->values[column]= PyFloat_FromDouble(d);
-                *row+= 8;
-                break;
-            }
-        case MYSQL_TYPE_DATETIME:
-        case MYSQL_TYPE_TIMESTAMP:
-            {
-                uint8_t len= 0;
-                int year= 0, month= 0, day= 0,
-                    hour= 0, minute= 0, second= 0, second_part= 0;
 
-                len= (uint8_t)mysql_net_field_length(row);
-                if (!len)
-                {
-                    self->values[column]= PyDateTime_FromDateAndTime(0,0,0,0,0,0,0);
-                    break;
-                }
-                year= uint2korr(*row);
-                month= uint1korr(*row + 2);
-                day= uint1korr(*row + 3);
-                if (len > 4)
-                {
-                    hour= uint1korr(*row + 4);
-                    minute= uint1korr(*row + 5);
-                    second= uint1korr(*row + 6);
-                }
-                if (len == 11)
-                    second_part= uint4korr(*row + 7);
-                self->values[column]= PyDateTime_FromDateAndTime(year, month, 
-                    day, hour, minute, second, second_part);
-                *row+= len;
-                break;
-            }
-        case MYSQL_TYPE_DATE:
-            {
-                uint8_t len= 0;
-                int year, month, day;
+    obj= is_date ? PyDate_FromDate(year, month, day) :
+                   PyDateTime_FromDateAndTime(year, month, day, hour, minute,
+                                              second, second_part);
+    if (!obj || !entry)
+        return obj;
 
-                len= (uint8_t)mysql_net_field_length(row);
+    if (cache->lookups >= MRDB_TEMPORAL_CACHE_CHECK)
+    {
+        /* less than 25% hits: a miss is cheap, but there is no benefit
+           for (mostly) unique values */
+        if (cache->hits * 4 < cache->lookups)
+        {
+            mrdb_temporal_cache_free(column);
+            return obj;
+        }
+        cache->lookups/= 2;
+        cache->hits/= 2;
+    }
+    Py_XDECREF(entry->value);
+    Py_INCREF(obj);
+    entry->value= obj;
+    entry->key= key;
+    return obj;
+}
+/* }}} */
 
-                if (!len)
-                {
-                    self->values[column]= PyDate_FromDate(0,0,0);
-                    break;
-                }
-                year= uint2korr(*row);
-                month= uint1korr(*row + 2);
-                day= uint1korr(*row + 3);
-                self->values[column]= PyDate_FromDate(year, month, day);
-                *row+= len;
-                break;
-            }
-        case MYSQL_TYPE_TIME:
-            {
-                uint8_t len= 0;
-                MYSQL_TIME tm;
-                memset(&tm, 0, sizeof(MYSQL_TIME));
+/* {{{ mrdb_parse_datetime_fixed
+   Fast path for values in canonical YYYY-MM-DD[ HH:MM:SS[.ffffff]]
+   format as sent by the server in text protocol.
 
-                len= (uint8_t)mysql_net_field_length(row);
-                if (!len)
-                {
-                    self->values[column]= Mrdb_GetTimeDelta(&tm);
-                    break;
-                }
-                tm.neg= uint1korr(*row);
-                tm.day= uint4korr(*row + 1);
-                tm.hour= uint1korr(*row + 5);
-                tm.minute= uint1korr(*row + 6);
-                tm.second= uint1korr(*row + 7);
-                if (len > 8)
-                    tm.second_part= uint4korr(*row + 8);
-                if (tm.day)
-                    tm.hour+= (tm.day * 24);
-                self->values[column]= Mrdb_GetTimeDelta(&tm);
-                *row+= len;
-                break;
-            }
-        case MYSQL_TYPE_TINY_BLOB:
-        case MYSQL_TYPE_MEDIUM_BLOB:
-        case MYSQL_TYPE_BLOB:
-        case MYSQL_TYPE_LONG_BLOB:
-        case MYSQL_TYPE_BIT:
-            {
-                unsigned long length= mysql_net_field_length(row);
-                if (length > self->fields[column].max_length)
-                    self->fields[column].max_length= length;
-                if (self->fields[column].charsetnr== CHARSET_BINARY)
-                {
-                    self->values[column]= 
-                            PyBytes_FromStringAndSize((const char *)*row, 
-                                                       (Py_ssize_t)length);
-                }
-                else {
-                    self->values[column]=
-                        PyUnicode_FromStringAndSize((const char *)*row, 
-                                                    (Py_ssize_t)length);
-                }
-                *row+= length;
-                break;
-            }
-        case MYSQL_TYPE_NEWDECIMAL:
-            {
-                unsigned long length= mysql_net_field_length(row);
+   Returns 0 on success, 1 if the value has a different format */
+static uint8_t
+mrdb_parse_datetime_fixed(const char *data, unsigned long length,
+                          MYSQL_TIME *tm)
+{
+    const char *layout= "dddd-dd-dd dd:dd:dd.dddddd";
+    unsigned long i;
+    unsigned int digits[20];
+    unsigned int n= 0;
 
-                if (length > 0)
-                {
-                    char *tmp= alloca(length + 1);
-                    memcpy(tmp, (const char *)*row, length);
-                    tmp[length]= 0;
-                    self->values[column]= PyObject_CallFunction(decimal_type, "s", tmp);
-                } else {
-                    self->values[column]= PyObject_CallFunction(decimal_type, "s", "0");
-                }
-                *row+= length;
-                break;
-            }
-        case MYSQL_TYPE_GEOMETRY:
-        case MYSQL_TYPE_STRING:
-        case MYSQL_TYPE_VAR_STRING:
-        case MYSQL_TYPE_JSON:
-        case MYSQL_TYPE_VARCHAR:
-        case MYSQL_TYPE_DECIMAL:
-        case MYSQL_TYPE_SET:
-        case MYSQL_TYPE_ENUM:
-        {
-            unsigned long length;
-            unsigned long utf8len;
-            length= mysql_net_field_length(row);
+    if (length != 10 && (length < 19 || length == 20 || length > 26))
+        return 1;
 
-            if (self->fields[column].charsetnr== CHARSET_BINARY)
-            {
-                self->values[column]=
-                        PyBytes_FromStringAndSize((const char *)*row,
-                                                   (Py_ssize_t)length);
-                if (length > self->fields[column].max_length)
-                    self->fields[column].max_length= length;
-            } else {
-                 self->values[column]= 
-                 PyUnicode_FromStringAndSize((const char *)*row,
-                                             (Py_ssize_t)length);
-                 utf8len= (unsigned long)PyUnicode_GET_LENGTH(self->values[column]);
-                 if (utf8len > self->fields[column].max_length)
-                    self->fields[column].max_length= utf8len;
-            }
-            *row+= length;
+    for (i=0; i < length; i++)
+    {
+        if (layout[i] == 'd')
+        {
+            if (data[i] < '0' || data[i] > '9')
+                return 1;
+            digits[n++]= data[i] - '0';
         }
-        default:
-            break;
+        else if (data[i] != layout[i])
+            return 1;
     }
-    /* check if values need to be converted */
-    if (self->connection->converter)
+
+    memset(tm, 0, sizeof(MYSQL_TIME));
+    tm->year= digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+    tm->month= digits[4] * 10 + digits[5];
+    tm->day= digits[6] * 10 + digits[7];
+    if (length == 10)
     {
-        PyObject *val;
-        enum enum_field_types type;
+        tm->time_type= MYSQL_TIMESTAMP_DATE;
+        return 0;
+    }
+    tm->hour= digits[8] * 10 + digits[9];
+    tm->minute= digits[10] * 10 + digits[11];
+    tm->second= digits[12] * 10 + digits[13];
+    for (i=14; i < 20; i++)
+    {
+        tm->second_part= tm->second_part * 10 + (i < n ? digits[i] : 0);
+    }
+    tm->time_type= MYSQL_TIMESTAMP_DATETIME;
+    return 0;
+}
+/* }}} */
 
-        if (ext_field_type && ext_field_type->ext_type == EXT_TYPE_JSON)
-          type= MYSQL_TYPE_JSON;
-        else
-          type= self->fields[column].type;
+static PyObject *
+mrdb_decode_bin_datetime(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    uint8_t len= 0;
+    int year= 0, month= 0, day= 0,
+        hour= 0, minute= 0, second= 0, second_part= 0;
 
-        if ((val= ma_convert_value(self, type, self->values[column])))
-            self->values[column]= val;
+    len= (uint8_t)mysql_net_field_length(row);
+    if (!len)
+    {
+        return PyDateTime_FromDateAndTime(0,0,0,0,0,0,0);
+    }
+    year= uint2korr(*row);
+    month= uint1korr(*row + 2);
+    day= uint1korr(*row + 3);
+    if (len > 4)
+    {
+        hour= uint1korr(*row + 4);
+        minute= uint1korr(*row + 5);
+        second= uint1korr(*row + 6);
     }
+    if (len == 11)
+        second_part= uint4korr(*row + 7);
+    *row+= len;
+    return mrdb_new_temporal(column, 0, year, month, day, hour, minute,
+                             second, second_part);
 }
-/* 
-   mariadb_get_column_info
-   This function analyzes the Python object and calculates the corresponding
-   MYSQL_TYPE, unsigned flag or NULL values and stores the information in
-   MrdbParamInfo pointer.
- */
-static uint8_t 
-mariadb_get_column_info(PyObject *obj, MrdbParamInfo *paraminfo)
+
+static PyObject *
+mrdb_decode_bin_date(MrdbColumn *column, unsigned char **row, unsigned long length)
 {
-    if (obj == NULL)
+    uint8_t len= 0;
+    int year, month, day;
+
+    len= (uint8_t)mysql_net_field_length(row);
+    if (!len)
     {
-        paraminfo->type= MYSQL_TYPE_NULL;
-        return 0;
+        return PyDate_FromDate(0,0,0);
     }
+    year= uint2korr(*row);
+    month= uint1korr(*row + 2);
+    day= uint1korr(*row + 3);
+    *row+= len;
+    return mrdb_new_temporal(column, 1, year, month, day, 0, 0, 0, 0);
+}
 
-    if (CHECK_TYPE(obj, &PyLong_Type))
+static PyObject *
+mrdb_decode_bin_time(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    uint8_t len= 0;
+    MYSQL_TIME tm;
+
+    memset(&tm, 0, sizeof(MYSQL_TIME));
+    len= (uint8_t)mysql_net_field_length(row);
+    if (!len)
     {
-        size_t b= _PyLong_NumBits(obj);
-        if (b > paraminfo->bits)
-            paraminfo->bits= b;
+        return Mrdb_GetTimeDelta(&tm);
+    }
+    tm.neg= uint1korr(*row);
+    tm.day= uint4korr(*row + 1);
+    tm.hour= uint1korr(*row + 5);
+    tm.minute= uint1korr(*row + 6);
+    tm.second= uint1korr(*row + 7);
+    if (len > 8)
+        tm.second_part= uint4korr(*row + 8);
+    if (tm.day)
+        tm.hour+= (tm.day * 24);
+    *row+= len;
+    return Mrdb_GetTimeDelta(&tm);
+}
+
+/* {{{ mrdb_is_ascii
+   Returns 1 if data doesn't contain any byte with the highest bit set */
+static inline uint8_t
+mrdb_is_ascii(const unsigned char *data, size_t length)
+{
+    size_t i= 0;
+    uint64_t word;
+
+#if defined(__AVX2__)
+    for (; i + 32 <= length; i+= 32)
+    {
+        __m256i v= _mm256_loadu_si256((const __m256i *)(data + i));
+        if (_mm256_movemask_epi8(v))
+            return 0;
+    }
+#endif
+#if defined(MRDB_HAVE_SSE2)
+    for (; i + 16 <= length; i+= 16)
+    {
+        __m128i v= _mm_loadu_si128((const __m128i *)(data + i));
+        if (_mm_movemask_epi8(v))
+            return 0;
+    }
+#endif
+    for (; i + 8 <= length; i+= 8)
+    {
+        memcpy(&word, data + i, 8);
+        if (word & 0x8080808080808080ULL)
+            return 0;
+    }
+    for (; i < length; i++)
+    {
+        if (data[i] & 0x80)
+            return 0;
+    }
+    return 1;
+}
+/* }}} */
+
+/* {{{ mrdb_unicode_from_data
+   Creates a unicode object from utf8 encoded data. Pure ASCII data
+   is copied into a compact ASCII object without decoding.
+   The number of characters will be stored in char_length */
+static inline PyObject *
+mrdb_unicode_from_data(const unsigned char *data, unsigned long length,
+                       unsigned long *char_length)
+{
+    PyObject *obj;
+
+    if (mrdb_is_ascii(data, length))
+    {
+        if (!(obj= PyUnicode_New((Py_ssize_t)length, 127)))
+            return NULL;
+        memcpy(PyUnicode_DATA(obj), data, length);
+        *char_length= length;
+        return obj;
+    }
+    if (!(obj= PyUnicode_DecodeUTF8((const char *)data, (Py_ssize_t)length, NULL)))
+        return NULL;
+    *char_length= (unsigned long)PyUnicode_GET_LENGTH(obj);
+    return obj;
+}
+/* }}} */
+
+/* binary character set: max_length is the length in bytes */
+static PyObject *
+mrdb_decode_bytes(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    if (length > column->max_length)
+        column->max_length= length;
+    return PyBytes_FromStringAndSize((const char *)*row, (Py_ssize_t)length);
+}
+
+/* binary character set, blob_as_memoryview: returns a read only view
+   into the buffered result set instead of a copy */
+static PyObject *
+mrdb_decode_memoryview(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *buffer, *view;
+
+    /* result was already released by the cursor */
+    if (!column->owner)
+        return mrdb_decode_bytes(column, row, length);
+
+    if (length > column->max_length)
+        column->max_length= length;
+    if (!(buffer= MrdbBlobBuffer_New(column->owner, *row, length)))
+        return NULL;
+    view= PyMemoryView_FromObject(buffer);
+    Py_DECREF(buffer);
+    return view;
+}
+
+/* stream_blobs: the value will be read from the raw row data with
+   open_blob(), so only the length of the value is returned */
+static PyObject *
+mrdb_decode_blob_length(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    if (length > column->max_length)
+        column->max_length= length;
+    return PyLong_FromUnsignedLong(length);
+}
+
+/* blob types: max_length is the length in bytes */
+static PyObject *
+mrdb_decode_blob(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    unsigned long char_length;
+
+    if (length > column->max_length)
+        column->max_length= length;
+    return mrdb_unicode_from_data(*row, length, &char_length);
+}
+
+/* string types: max_length is the length in characters */
+static PyObject *
+mrdb_decode_string(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj;
+    unsigned long char_length;
+
+    if (!(obj= mrdb_unicode_from_data(*row, length, &char_length)))
+        return NULL;
+    if (char_length > column->max_length)
+        column->max_length= char_length;
+    return obj;
+}
+
+/* {{{ mrdb_string_cache_free */
+static void
+mrdb_string_cache_free(MrdbColumn *column)
+{
+    uint32_t i;
+
+    if (!column->string_cache)
+        return;
+    for (i=0; i < MRDB_STRING_CACHE_SLOTS; i++)
+    {
+        Py_XDECREF(column->string_cache->entries[i].value);
+    }
+    MARIADB_FREE_MEM(column->string_cache);
+}
+/* }}} */
+
+/* string types with string cache: returns the cached object if the
+   same value was decoded before. If the hit rate is too low, the
+   cache will be disabled for the rest of the result set */
+static PyObject *
+mrdb_decode_string_cached(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    MrdbStringCache *cache= column->string_cache;
+    MrdbStringCacheEntry *entry;
+    PyObject *obj;
+    uint32_t hash= 2166136261U;
+    unsigned long i, char_length;
+
+    if (length > MRDB_STRING_CACHE_MAX_LENGTH)
+        return mrdb_decode_string(column, row, length);
+
+    /* FNV-1a */
+    for (i=0; i < length; i++)
+    {
+        hash^= (*row)[i];
+        hash*= 16777619U;
+    }
+    entry= &cache->entries[hash & (MRDB_STRING_CACHE_SLOTS - 1)];
+    cache->lookups++;
+
+    if (entry->value && entry->hash == hash && entry->length == length &&
+        !memcmp(entry->key, *row, length))
+    {
+        cache->hits++;
+        Py_INCREF(entry->value);
+        return entry->value;
+    }
+
+    if (!(obj= mrdb_unicode_from_data(*row, length, &char_length)))
+        return NULL;
+    if (char_length > column->max_length)
+        column->max_length= char_length;
+
+    if (cache->lookups >= MRDB_STRING_CACHE_CHECK)
+    {
+        /* less than 50% hits: disable cache */
+        if (cache->hits * 2 < cache->lookups)
+        {
+            if (column->decode == mrdb_decode_string_cached)
+                column->decode= mrdb_decode_string;
+            if (column->decode_value == mrdb_decode_string_cached)
+                column->decode_value= mrdb_decode_string;
+            mrdb_string_cache_free(column);
+            return obj;
+        }
+        cache->lookups/= 2;
+        cache->hits/= 2;
+    }
+
+    Py_XDECREF(entry->value);
+    Py_INCREF(obj);
+    entry->value= obj;
+    entry->hash= hash;
+    entry->length= length;
+    entry->char_length= char_length;
+    memcpy(entry->key, *row, length);
+    return obj;
+}
+
+/* Integer values which fit into 64 bit are converted directly from
+   the column data, arbitrary precision conversion via PyLong_FromString
+   is only used as fallback. */
+static PyObject *
+mrdb_decode_text_integer(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    const char *p= (const char *)*row;
+    const char *end= p + length;
+    uint8_t neg= 0;
+    uint64_t val= 0;
+
+    if (p < end && *p == '-')
+    {
+        neg= 1;
+        p++;
+    }
+    if (p == end)
+        goto fallback;
+
+    /* CONPY-258: leading zero's (ZEROFILL) don't need special handling */
+    for (; p < end; p++)
+    {
+        unsigned int digit= (unsigned char)*p - '0';
+
+        if (digit > 9 || val > (UINT64_MAX - digit) / 10)
+            goto fallback;
+        val= val * 10 + digit;
+    }
+    if (!neg)
+    {
+        if (val <= INT64_MAX)
+            return PyLong_FromLongLong((long long)val);
+        return PyLong_FromUnsignedLongLong((unsigned long long)val);
+    }
+    if (val <= (uint64_t)INT64_MAX + 1)
+        return PyLong_FromLongLong(val ? -(long long)(val - 1) - 1 : 0);
+
+fallback:
+    p= (const char *)*row;
+    if (length > 1)
+    {
+        while (*p && *p == '0')
+            p++;
+    }
+    return PyLong_FromString(p, NULL, 10);
+}
+
+static PyObject *
+mrdb_decode_text_double(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    double d;
+
+    /* correctly rounded and locale independent */
+    d= PyOS_string_to_double((const char *)*row, NULL, NULL);
+    if (d == -1.0 && PyErr_Occurred())
+        return NULL;
+    return PyFloat_FromDouble(d);
+}
+
+/* DECIMAL_FORMAT_DECIMAL: decimal.Decimal object */
+static PyObject *
+mrdb_decode_decimal(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *str, *obj;
+    unsigned long char_length;
+
+    str= length ? mrdb_unicode_from_data(*row, length, &char_length) :
+                  PyUnicode_FromStringAndSize("0", 1);
+    if (!str)
+        return NULL;
+    obj= PyObject_Vectorcall(decimal_type, &str, 1, NULL);
+    Py_DECREF(str);
+    return obj;
+}
+
+/* DECIMAL_FORMAT_STR: string representation */
+static PyObject *
+mrdb_decode_decimal_str(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    unsigned long char_length;
+
+    if (!length)
+        return PyUnicode_FromStringAndSize("0", 1);
+    return mrdb_unicode_from_data(*row, length, &char_length);
+}
+
+/* DECIMAL_FORMAT_FLOAT: float (might lose precision) */
+static PyObject *
+mrdb_decode_decimal_float(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    char buf[MAX_DECIMAL_BUFSIZE];
+    double d;
+
+    if (!length)
+        return PyFloat_FromDouble(0.0);
+    if (length >= MAX_DECIMAL_BUFSIZE)
+        goto error;
+
+    /* in binary protocol the value isn't zero terminated */
+    memcpy(buf, *row, length);
+    buf[length]= 0;
+    d= PyOS_string_to_double(buf, NULL, NULL);
+    if (d == -1.0 && PyErr_Occurred())
+        return NULL;
+    return PyFloat_FromDouble(d);
+error:
+    mariadb_throw_exception(NULL, Mariadb_DataError, 0,
+                            "Invalid decimal value");
+    return NULL;
+}
+
+/* DECIMAL_FORMAT_INT: integer value scaled by 10^decimals */
+static PyObject *
+mrdb_decode_decimal_int(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    char buf[MAX_DECIMAL_BUFSIZE];
+    char *p= buf;
+    const char *data= (const char *)*row;
+    const char *end= data + length;
+    unsigned int frac= 0;
+    uint8_t in_frac= 0;
+
+    for (; data < end; data++)
+    {
+        if (*data == '.')
+        {
+            in_frac= 1;
+            continue;
+        }
+        if (in_frac && frac++ == column->decimals)
+            break;
+        if (p - buf >= MAX_DECIMAL_BUFSIZE - 1)
+            goto error;
+        *p++= *data;
+    }
+    /* fill up missing fraction digits */
+    for (; frac < column->decimals; frac++)
+    {
+        if (p - buf >= MAX_DECIMAL_BUFSIZE - 1)
+            goto error;
+        *p++= '0';
+    }
+    if (p == buf)
+        *p++= '0';
+    *p= 0;
+
+    p= buf;
+    return mrdb_decode_text_integer(column, (unsigned char **)&p,
+                                    (unsigned long)strlen(buf));
+error:
+    mariadb_throw_exception(NULL, Mariadb_DataError, 0,
+                            "Invalid decimal value");
+    return NULL;
+}
+
+/* binary protocol: decodes length encoded values like strings, blobs
+   and decimals with the value decoder which is also used for text
+   protocol */
+static PyObject *
+mrdb_decode_bin_lenenc(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    PyObject *obj;
+
+    length= mysql_net_field_length(row);
+    obj= column->decode_value(column, row, length);
+    *row+= length;
+    return obj;
+}
+
+static PyObject *
+mrdb_decode_text_time(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    MYSQL_TIME tm;
+
+    memset(&tm, 0, sizeof(MYSQL_TIME));
+    Py_str_to_TIME((const char *)*row, length, &tm);
+    if (check_time(&tm))
+    {
+        return Mrdb_GetTimeDelta(&tm);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+mrdb_decode_text_date(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    MYSQL_TIME tm;
+
+    if (mrdb_parse_datetime_fixed((const char *)*row, length, &tm))
+    {
+        memset(&tm, 0, sizeof(MYSQL_TIME));
+        Py_str_to_TIME((const char *)*row, length, &tm);
+    }
+    if (check_date(tm.year, tm.month, tm.day))
+    {
+        return mrdb_new_temporal(column, 1, tm.year, tm.month, tm.day,
+                                 0, 0, 0, 0);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+mrdb_decode_text_datetime(MrdbColumn *column, unsigned char **row, unsigned long length)
+{
+    MYSQL_TIME tm;
+
+    if (mrdb_parse_datetime_fixed((const char *)*row, length, &tm))
+    {
+        memset(&tm, 0, sizeof(MYSQL_TIME));
+        Py_str_to_TIME((const char *)*row, length, &tm);
+    }
+    if (check_date(tm.year, tm.month, tm.day) && check_time(&tm))
+    {
+        return mrdb_new_temporal(column, 0, tm.year, tm.month, tm.day,
+                                 tm.hour, tm.minute, tm.second,
+                                 tm.second_part);
+    }
+    Py_RETURN_NONE;
+}
+/* }}} */
+
+/* {{{ mariadb_decimal_decoder */
+static MrdbColumn_Decode
+mariadb_decimal_decoder(MrdbColumn *column)
+{
+    switch (column->decimal_format) {
+        case DECIMAL_FORMAT_STR:
+            return mrdb_decode_decimal_str;
+        case DECIMAL_FORMAT_FLOAT:
+            return mrdb_decode_decimal_float;
+        case DECIMAL_FORMAT_INT:
+            return mrdb_decode_decimal_int;
+        default:
+            return mrdb_decode_decimal;
+    }
+}
+/* }}} */
+
+/* {{{ mariadb_binary_decoder */
+static MrdbColumn_Decode
+mariadb_binary_decoder(MrdbColumn *column)
+{
+    switch(column->type) {
+        case MYSQL_TYPE_NULL:
+            return mrdb_decode_none;
+        case MYSQL_TYPE_TINY:
+            return column->is_unsigned ? mrdb_decode_bin_utiny :
+                                         mrdb_decode_bin_tiny;
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_YEAR:
+            return column->is_unsigned ? mrdb_decode_bin_ushort :
+                                         mrdb_decode_bin_short;
+        case MYSQL_TYPE_INT24:
+            return column->is_unsigned ? mrdb_decode_bin_uint24 :
+                                         mrdb_decode_bin_int24;
+        case MYSQL_TYPE_LONG:
+            return column->is_unsigned ? mrdb_decode_bin_ulong :
+                                         mrdb_decode_bin_long;
+        case MYSQL_TYPE_LONGLONG:
+            return column->is_unsigned ? mrdb_decode_bin_ulonglong :
+                                         mrdb_decode_bin_longlong;
+        case MYSQL_TYPE_FLOAT:
+            return mrdb_decode_bin_float;
+        case MYSQL_TYPE_DOUBLE:
+            return mrdb_decode_bin_double;
+        case MYSQL_TYPE_DATETIME:
+        case MYSQL_TYPE_TIMESTAMP:
+            return mrdb_decode_bin_datetime;
+        case MYSQL_TYPE_DATE:
+            return mrdb_decode_bin_date;
+        case MYSQL_TYPE_TIME:
+            return mrdb_decode_bin_time;
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_BIT:
+            column->decode_value= column->is_binary ? mrdb_decode_bytes :
+                                                      mrdb_decode_blob;
+            return mrdb_decode_bin_lenenc;
+        case MYSQL_TYPE_NEWDECIMAL:
+            column->decode_value= mariadb_decimal_decoder(column);
+            return mrdb_decode_bin_lenenc;
+        default:
+            /* all other types are sent as length encoded strings */
+            column->decode_value= column->is_binary ? mrdb_decode_bytes :
+                                                      mrdb_decode_string;
+            return mrdb_decode_bin_lenenc;
+    }
+}
+/* }}} */
+
+/* {{{ mariadb_text_decoder */
+static MrdbColumn_Decode
+mariadb_text_decoder(MrdbColumn *column)
+{
+    switch (column->type)
+    {
+        case MYSQL_TYPE_NULL:
+            return mrdb_decode_none;
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_YEAR:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_LONGLONG:
+            return mrdb_decode_text_integer;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+            return mrdb_decode_text_double;
+        case MYSQL_TYPE_TIME:
+            return mrdb_decode_text_time;
+        case MYSQL_TYPE_DATE:
+            return mrdb_decode_text_date;
+        case MYSQL_TYPE_DATETIME:
+        case MYSQL_TYPE_TIMESTAMP:
+            return mrdb_decode_text_datetime;
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_GEOMETRY:
+        case MYSQL_TYPE_BIT:
+            return column->is_binary ? mrdb_decode_bytes : mrdb_decode_blob;
+        case MYSQL_TYPE_NEWDECIMAL:
+            return mariadb_decimal_decoder(column);
+        default:
+            return column->is_binary ? mrdb_decode_bytes : mrdb_decode_string;
+    }
+}
+/* }}} */
+
+/* {{{ mrdb_stream_blob
+   Checks if values of a column will be read with open_blob() only:
+   BLOB and TEXT values without a converter */
+static uint8_t
+mrdb_stream_blob(MrdbCursor *self, MrdbColumn *column)
+{
+    if (!self->stream_blobs || column->converter)
+        return 0;
+
+    switch (column->type) {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+            return 1;
+        default:
+            return 0;
+    }
+}
+/* }}} */
+
+/* {{{ mrdb_blob_as_memoryview
+   Checks if values of a column can be returned as memoryviews: The
+   rows of the result set must stay in memory until the result set
+   will be released, which is the case for buffered results only.
+   Server side cursors fetch rows in batches, lazy rows keep a copy of
+   raw data anyway. Results with a memory limit are stored in a spool,
+   which is released with the result set. */
+static uint8_t
+mrdb_blob_as_memoryview(MrdbCursor *self, MrdbColumn *column)
+{
+    if (!self->blob_as_memoryview || !self->is_buffered ||
+        self->buffer_limit || self->result_format == RESULT_LAZY ||
+        !column->is_binary || column->converter)
+        return 0;
+
+    /* a binary protocol handle will be handed over to the result holder,
+       so it must not have further result sets */
+    if (!self->parseinfo.is_text &&
+        (self->cursor_type != CURSOR_TYPE_NO_CURSOR ||
+         self->parseinfo.command == SQL_CALL))
+        return 0;
+
+    switch (column->type) {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_VARCHAR:
+            return 1;
+        default:
+            return 0;
+    }
+}
+/* }}} */
+
+/* {{{ MrdbColumnPlan_dealloc */
+static void
+MrdbColumnPlan_dealloc(MrdbColumnPlan *self)
+{
+    uint32_t i;
+
+    if (self->columns)
+    {
+        for (i=0; i < self->column_count; i++)
+        {
+            Py_XDECREF(self->columns[i].converter);
+            Py_XDECREF(self->columns[i].name);
+            mrdb_string_cache_free(&self->columns[i]);
+            mrdb_temporal_cache_free(&self->columns[i]);
+        }
+        MARIADB_FREE_MEM(self->columns);
+    }
+    Py_XDECREF(self->column_index);
+    PyObject_Del(self);
+}
+/* }}} */
+
+PyTypeObject MrdbColumnPlan_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mariadb.columnplan",
+    .tp_basicsize= (Py_ssize_t)sizeof(MrdbColumnPlan),
+    .tp_dealloc= (destructor)MrdbColumnPlan_dealloc,
+    .tp_flags= Py_TPFLAGS_DEFAULT,
+};
+
+/* {{{ mariadb_init_column_plan
+   Builds the decode plan for the current result set. Must be called
+   after field information was retrieved.
+
+   Returns 0 on success, 1 on error (exception is set) */
+uint8_t
+mariadb_init_column_plan(MrdbCursor *self)
+{
+    MrdbColumnPlan *plan;
+    uint32_t i;
+
+    mariadb_free_column_plan(self);
+
+    if (!self->field_count || !self->fields)
+        return 0;
+
+    if (!(plan= PyObject_New(MrdbColumnPlan, &MrdbColumnPlan_Type)))
+        return 1;
+    plan->column_count= 0;
+    plan->column_index= NULL;
+    plan->is_text= self->parseinfo.is_text;
+    self->plan= plan;
+
+    if (!(plan->columns= (MrdbColumn *)PyMem_RawCalloc(self->field_count,
+                                                       sizeof(MrdbColumn))))
+    {
+        PyErr_NoMemory();
+        goto error;
+    }
+    plan->column_count= self->field_count;
+
+    for (i=0; i < self->field_count; i++)
+    {
+        MrdbColumn *column= &plan->columns[i];
+        MYSQL_FIELD *field= &self->fields[i];
+        Mrdb_ExtFieldType *ext_field_type= mariadb_extended_field_type(field);
+
+        column->type= field->type;
+        column->ext_type= ext_field_type ? ext_field_type->ext_type : EXT_TYPE_NONE;
+        column->is_unsigned= (field->flags & UNSIGNED_FLAG) ? 1 : 0;
+        column->is_binary= (field->charsetnr == CHARSET_BINARY);
+        column->decimals= field->decimals;
+        column->decimal_format= self->decimal_format;
+        column->converter_type= (column->ext_type == EXT_TYPE_JSON) ?
+                                MYSQL_TYPE_JSON : field->type;
+        column->converter= ma_get_converter(self, column->converter_type);
+        column->decode= self->parseinfo.is_text ? mariadb_text_decoder(column) :
+                                                  mariadb_binary_decoder(column);
+
+        /* ENUM and SET values are always cached, other string columns
+           only if the cursor was created with intern_strings option */
+        if (!column->is_binary &&
+            (field->flags & (ENUM_FLAG | SET_FLAG) ||
+             (self->intern_strings && column->ext_type == EXT_TYPE_NONE)))
+        {
+            MrdbColumn_Decode *decode= self->parseinfo.is_text ?
+                                       &column->decode : &column->decode_value;
+
+            if (*decode == mrdb_decode_string &&
+                (column->string_cache= (MrdbStringCache *)
+                   PyMem_RawCalloc(1, sizeof(MrdbStringCache))))
+            {
+                *decode= mrdb_decode_string_cached;
+            }
+        }
+
+        if (mrdb_stream_blob(self, column))
+        {
+            MrdbColumn_Decode *decode= self->parseinfo.is_text ?
+                                       &column->decode : &column->decode_value;
+
+            *decode= mrdb_decode_blob_length;
+        }
+        else if (mrdb_blob_as_memoryview(self, column))
+        {
+            MrdbColumn_Decode *decode= self->parseinfo.is_text ?
+                                       &column->decode : &column->decode_value;
+
+            if (!self->result_holder &&
+                !(self->result_holder= MrdbResultHolder_New(self->connection)))
+                goto error;
+            column->owner= (PyObject *)self->result_holder;
+            *decode= mrdb_decode_memoryview;
+        }
+
+        if (column->type == MYSQL_TYPE_DATE ||
+            column->type == MYSQL_TYPE_DATETIME ||
+            column->type == MYSQL_TYPE_TIMESTAMP)
+        {
+            column->temporal_cache= (MrdbTemporalCache *)
+                PyMem_RawCalloc(1, sizeof(MrdbTemporalCache));
+        }
+    }
+
+    /* Dictionary rows are copied from a template which already contains
+       all keys, so setting the column values doesn't need to create keys
+       or resize the dictionary */
+    if (self->result_format == RESULT_DICTIONARY)
+    {
+        if (!(self->row_template= PyDict_New()))
+            goto error;
+        for (i=0; i < self->field_count; i++)
+        {
+            MrdbColumn *column= &plan->columns[i];
+
+            if (!(column->name= PyUnicode_InternFromString(self->fields[i].name)) ||
+                PyDict_SetItem(self->row_template, column->name, Py_None))
+                goto error;
+        }
+    }
+
+    /* Lazy rows support access by column name */
+    if (self->result_format == RESULT_LAZY)
+    {
+        if (!(plan->column_index= PyDict_New()))
+            goto error;
+        for (i=0; i < self->field_count; i++)
+        {
+            PyObject *index;
+
+            if (!(index= PyLong_FromUnsignedLong(i)))
+                goto error;
+            if (PyDict_SetItemString(plan->column_index, self->fields[i].name,
+                                     index))
+            {
+                Py_DECREF(index);
+                goto error;
+            }
+            Py_DECREF(index);
+        }
+    }
+    return 0;
+error:
+    mariadb_free_column_plan(self);
+    return 1;
+}
+/* }}} */
+
+/* {{{ mariadb_free_column_plan */
+void
+mariadb_free_column_plan(MrdbCursor *self)
+{
+    Py_CLEAR(self->row_template);
+    Py_CLEAR(self->plan);
+}
+/* }}} */
+
+/* {{{ mariadb_decode_raw_value
+   Decodes a raw column value of a lazy row, returns a new reference or
+   NULL if an error occurred */
+PyObject *
+mariadb_decode_raw_value(MrdbColumnPlan *plan, uint32_t column,
+                         MrdbRawValue *raw)
+{
+    MrdbColumn *col= &plan->columns[column];
+    unsigned char *data= raw->data;
+    PyObject *value;
+
+    if (!data)
+    {
+        /* Like in field_fetch_fromtext/field_fetch_callback NULL values are
+           passed to converter for text protocol only */
+        Py_INCREF(Py_None);
+        if (!plan->is_text)
+            return Py_None;
+        value= Py_None;
+    }
+    else if (!(value= col->decode(col, &data, raw->length)))
+        return NULL;
+    return col->converter ? ma_convert_value(col, value) : value;
+}
+/* }}} */
+
+/* {{{ mrdb_binary_value_length
+   Returns the length of a binary protocol value in row buffer including
+   the length prefix */
+static unsigned long
+mrdb_binary_value_length(MrdbColumn *column, unsigned char *row)
+{
+    unsigned char *p= row;
+    unsigned long length;
+
+    switch (column->type) {
+        case MYSQL_TYPE_NULL:
+            return 0;
+        case MYSQL_TYPE_TINY:
+            return 1;
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_YEAR:
+            return 2;
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_FLOAT:
+            return 4;
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_DOUBLE:
+            return 8;
+        default:
+            /* temporal values and length encoded values */
+            length= mysql_net_field_length(&p);
+            return (unsigned long)(p - row) + length;
+    }
+}
+/* }}} */
+
+void
+field_fetch_fromtext(MrdbCursor *self, char *data, unsigned long length,
+                     unsigned int column)
+{
+    MrdbColumn *col= &self->plan->columns[column];
+    PyObject *value;
+
+    if (!data)
+    {
+        Py_INCREF(Py_None);
+        value= Py_None;
+    } else {
+        if (!(value= col->decode(col, (unsigned char **)&data, length)))
+        {
+            self->values[column]= NULL;
+            return;
+        }
+    }
+    /* check if values need to be converted */
+    self->values[column]= col->converter ? ma_convert_value(col, value) : value;
+}
+
+/* field_fetch_callback
+   This function was previously registered with mysql_stmt_attr_set and
+   STMT_ATTR_FIELD_FETCH_CALLBACK parameter. Instead of filling a bind 
+   buffer MariaDB Connector/C sends raw data in row for the specified column.
+   In case of a NULL value row ptr will be NULL.
+
+   The cursor handle was also previously registered with mysql_stmt_attr_set
+   and STMT_ATTR_USER_DATA parameter and will be passed in data variable.
+*/
+
+void
+field_fetch_callback(void *data, unsigned int column, unsigned char **row)
+{
+    MrdbCursor *self= (MrdbCursor *)data;
+    MrdbColumn *col= &self->plan->columns[column];
+
+    /* open_blob reads from the raw data of the current row */
+    col->current= row ? *row : NULL;
+
+    /* adaptive fetch size and byte limits need the size of fetched rows */
+    if (self->measure_bytes && row)
+        self->row_bytes+= mrdb_binary_value_length(col, *row);
+
+    /* lazy rows and columnar fetch: save position and length of raw data
+       only, the values will be copied after all columns were processed */
+    if (self->fetch_raw)
+    {
+        MrdbRawValue *raw= &self->raw_values[column];
+
+        if (!(raw->data= row ? *row : NULL))
+            return;
+        raw->length= mrdb_binary_value_length(col, *row);
+        *row+= raw->length;
+        return;
+    }
+
+    /* A previous column of this row couldn't be decoded: the row will be
+       discarded, so there is no need to decode the remaining columns */
+    if (PyErr_Occurred())
+    {
+        self->values[column]= NULL;
+        return;
+    }
+
+    if (!row)
+    {
+        Py_INCREF(Py_None);
+        self->values[column]= Py_None;
+        return;
+    }
+    if (!(self->values[column]= col->decode(col, row, 0)))
+        return;
+
+    /* check if values need to be converted */
+    if (col->converter)
+        self->values[column]= ma_convert_value(col, self->values[column]);
+}
+
+/* {{{ mariadb_prefetch_callback
+   Replaces field_fetch_callback while a background reader is active.
+   It is called without holding the GIL, so only position and length of
+   the raw data will be saved. */
+void
+mariadb_prefetch_callback(void *data, unsigned int column, unsigned char **row)
+{
+    MrdbPrefetch *prefetch= (MrdbPrefetch *)data;
+    MrdbRawValue *raw= &prefetch->current[column];
+
+    if (!(raw->data= row ? *row : NULL))
+        return;
+    raw->length= mrdb_binary_value_length(&prefetch->plan->columns[column],
+                                          *row);
+    *row+= raw->length;
+}
+/* }}} */
+/* 
+   mariadb_get_column_info
+   This function analyzes the Python object and calculates the corresponding
+   MYSQL_TYPE, unsigned flag or NULL values and stores the information in
+   MrdbParamInfo pointer.
+ */
+static uint8_t 
+mariadb_get_column_info(PyObject *obj, MrdbParamInfo *paraminfo)
+{
+    if (obj == NULL)
+    {
+        paraminfo->type= MYSQL_TYPE_NULL;
+        return 0;
+    }
+
+    if (CHECK_TYPE(obj, &PyLong_Type))
+    {
+        size_t b= _PyLong_NumBits(obj);
+        if (b > paraminfo->bits)
+            paraminfo->bits= b;
         paraminfo->type= MYSQL_TYPE_LONGLONG;
         return 0;
     } else if (CHECK_TYPE(obj, &PyBool_Type)) {
@@ -912,357 +1784,1097 @@ mariadb_get_column_info(PyObject *obj, MrdbParamInfo *paraminfo)
         return 0;
     }
     else {
-        /* If Object has string representation, we will use string representation */ 
-        /* no corresponding object, return error  */
-        return 2;
+        /* If Object has string representation, we will use string representation */ 
+        /* no corresponding object, return error  */
+        return 2;
+    }
+
+    return 1;
+}
+
+PyObject *ListOrTuple_GetItem(PyObject *obj, Py_ssize_t index)
+{
+    if (CHECK_TYPE(obj, &PyList_Type))
+    {
+        return PyList_GetItem(obj, index);
+    } else if (CHECK_TYPE(obj, &PyTuple_Type))
+    {
+        return PyTuple_GetItem(obj, index);
+    }
+    /* this should never happen, since the type was checked before */
+    return NULL;
+}
+
+/* 
+
+   mariadb_get_parameter()
+   @brief   Returns a bulk parameter which was passed to
+   cursor.executemany() or a parameter which was
+   passed to cursor.execute()
+
+   @param   self[in]         Cursor
+   @param   row_nr[in]       row number
+   @paran   column_nr[in]    column number
+   @param   paran[in][out]   bulk parameter pointer
+
+   @return  0 on success, 1 on error
+ */
+static uint8_t 
+mariadb_get_parameter(MrdbCursor *self,
+                      uint8_t is_bulk,
+                      uint32_t row_nr,
+                      uint32_t column_nr,
+                      MrdbParamValue *param)
+{
+    PyObject *row= NULL,
+             *column= NULL;
+    uint8_t rc= 1;
+
+    if (is_bulk)
+    {
+        /* check if row_nr and column_nr are in the range from
+           0 to (value - 1) */
+        if (row_nr > (self->array_size - 1) ||
+                column_nr > (self->parseinfo.paramcount - 1))
+        {
+            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
+                    "Can't access data at row %d, column %d",
+                     row_nr + 1, column_nr + 1);
+            goto end;
+        }
+
+        if (!(row= ListOrTuple_GetItem(self->data, row_nr)))
+        {
+            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
+                    "Can't access row number %d", row_nr + 1);
+            goto end;
+        }
+    }
+    else
+        row= self->data;
+
+    if (self->parseinfo.paramstyle != PYFORMAT)
+    {
+        if (!(column= ListOrTuple_GetItem(row, column_nr)))
+        {
+            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
+                    "Can't access column number %d at row %d",
+                     column_nr + 1, row_nr + 1);
+            goto end;
+        }
+    } else
+    {
+        PyObject *key;
+
+        key= PyTuple_GetItem(self->parseinfo.keys, column_nr);
+        if (!PyDict_Contains(row, key))
+        {
+            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
+                    "Can't find key in parameter data");
+            goto end;
+        }
+        column= PyDict_GetItem(row, key);
+    }
+
+    /* check if an indicator was passed */
+    if (MrdbIndicator_Check(column))
+    {
+        if (!MRDB_BULK_SUPPORTED(self->connection))
+        {
+            mariadb_throw_exception(NULL, Mariadb_NotSupportedError, 0,
+                    "MariaDB %s doesn't support indicator variables. "\
+                    "Required version is 10.2.6 or newer",
+                    mysql_get_server_info(self->stmt->mysql));
+            goto end;
+        }
+        param->indicator= (uint8_t)MrdbIndicator_AsLong(column);
+        param->value= NULL; /* you can't have both indicator and value */
+    } else if (column == Py_None) {
+        param->value= NULL;
+        if (MRDB_BULK_SUPPORTED(self->connection))
+        {
+            param->indicator= STMT_INDICATOR_NULL;
+        }
+    } 
+    else {
+        param->value= column;
+        param->indicator= STMT_INDICATOR_NONE;
+    }
+    rc= 0;
+end:
+    return rc;
+}
+
+/* 
+   mariadb_get_parameter_info
+   mariadb_get_parameter_info fills the MYSQL_BIND structure
+   with correct field_types for the Python objects.
+*/
+static uint8_t 
+mariadb_get_parameter_info(MrdbCursor *self,
+                           MYSQL_BIND *param,
+                           uint32_t column_nr)
+{
+    uint32_t bits= 0;
+    MrdbParamValue paramvalue;
+    MrdbParamInfo pinfo;
+    uint8_t rc;
+
+    param->is_unsigned= 0;
+    paramvalue.indicator= 0;
+
+    memset(&pinfo, 0, sizeof(MrdbParamInfo));
+    if (mariadb_get_parameter(self, 0, 0, column_nr, &paramvalue))
+        return 1;
+    if ((rc= mariadb_get_column_info(paramvalue.value, &pinfo)))
+    {
+        if (rc == 1)
+        {
+            mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Can't retrieve column information for parameter %d",
+                 column_nr);
+        }
+        if (rc == 2)
+        {
+            mariadb_throw_exception(NULL, Mariadb_NotSupportedError, 0,
+                "Data type '%s' in column %d not supported in MariaDB Connector/Python",
+                 Py_TYPE(paramvalue.value)->tp_name, column_nr);
+        }
+   
+        return 1;
+    }
+    param->buffer_type= pinfo.type;
+    bits= (uint32_t)pinfo.bits;
+
+    /* check the bit size for long types and set the appropriate
+       field type */
+    if (param->buffer_type == MYSQL_TYPE_LONGLONG)
+    {
+        if ((bits <= 8 && param->is_unsigned) || bits < 8)
+        {
+            param->buffer_type= MYSQL_TYPE_TINY;
+        }
+        else if ((bits <= 16 && param->is_unsigned) || bits < 16) {
+            param->buffer_type= MYSQL_TYPE_SHORT;
+        }
+        else if ((bits <= 32 && param->is_unsigned) || bits < 32) {
+            param->buffer_type= MYSQL_TYPE_LONG;
+        }
+        else {
+            param->buffer_type= MYSQL_TYPE_LONGLONG;
+        }
     }
+    return 0;
+}
 
+/* numeric types of bulk columns can be widened: an integer column
+   becomes a double or decimal column, a double column a decimal column */
+#define BULK_NUMERIC_RANK(type) \
+((type) == MYSQL_TYPE_LONGLONG ? 1 : (type) == MYSQL_TYPE_DOUBLE ? 2 : \
+ (type) == MYSQL_TYPE_NEWDECIMAL ? 3 : 0)
+
+#define BULK_ARENA_INITIAL_SIZE 4096
+#define BULK_INITIAL_ROWS 1024
+
+/* size of a length encoded string prefix */
+#define BULK_LENENC_SIZE(len) \
+((len) < 251 ? 1 : (len) < 65536 ? 3 : (len) < 16777216 ? 4 : 9)
+
+/* command, statement id, flags and parameter types of a bulk request */
+#define BULK_REQUEST_OVERHEAD(params) (16 + 2 * (size_t)(params))
+
+static uint8_t
+mariadb_bulk_type_error(Py_ssize_t row_nr, uint32_t column_nr)
+{
+    mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 1,
+            "Invalid parameter type at row %zd, column %d",
+            row_nr + 1, column_nr + 1);
     return 1;
 }
 
-PyObject *ListOrTuple_GetItem(PyObject *obj, Py_ssize_t index)
+/* {{{ mariadb_bulk_store_string
+   Copies a string into the arena of a decimal column. Since the arena
+   might be reallocated, the offset will be stored and translated into
+   a pointer after all rows were processed */
+static uint8_t
+mariadb_bulk_store_string(MrdbBulkColumn *col, uint32_t row_nr,
+                          const char *str, size_t length)
 {
-    if (CHECK_TYPE(obj, &PyList_Type))
+    if (col->arena_length + length > col->arena_size)
     {
-        return PyList_GetItem(obj, index);
-    } else if (CHECK_TYPE(obj, &PyTuple_Type))
+        size_t new_size= col->arena_size ? col->arena_size * 2 :
+                                           BULK_ARENA_INITIAL_SIZE;
+        char *arena;
+
+        while (new_size < col->arena_length + length)
+            new_size*= 2;
+        if (!(arena= (char *)PyMem_RawRealloc(col->arena, new_size)))
+        {
+            PyErr_NoMemory();
+            return 1;
+        }
+        col->arena= arena;
+        col->arena_size= new_size;
+    }
+    memcpy(col->arena + col->arena_length, str, length);
+    col->values[row_nr].offset= col->arena_length;
+    col->length[row_nr]= (unsigned long)length;
+    col->arena_length+= length;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mariadb_bulk_set_type
+   Sets the type of a column which contained NULL values only and
+   allocates the additional arrays required by this type */
+static uint8_t
+mariadb_bulk_set_type(MrdbBulkColumn *col, enum enum_field_types type,
+                      uint32_t array_size)
+{
+    switch (type) {
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_NEWDECIMAL:
+            if (!col->length &&
+                !(col->length= (unsigned long *)PyMem_RawCalloc(array_size,
+                                                   sizeof(unsigned long))))
+                goto error;
+            break;
+        case MYSQL_TYPE_DATE:
+        case MYSQL_TYPE_TIME:
+        case MYSQL_TYPE_DATETIME:
+            if (!(col->tm= (MYSQL_TIME *)PyMem_RawCalloc(array_size,
+                                                         sizeof(MYSQL_TIME))))
+                goto error;
+            break;
+        default:
+            break;
+    }
+    col->type= type;
+    return 0;
+error:
+    PyErr_NoMemory();
+    return 1;
+}
+/* }}} */
+
+/* {{{ mariadb_bulk_widen
+   Converts the values of the rows which were already stored into a
+   column into the wider numeric type */
+static uint8_t
+mariadb_bulk_widen(MrdbBulkColumn *col, enum enum_field_types type,
+                   uint32_t row_count, uint32_t array_size)
+{
+    enum enum_field_types old_type= col->type;
+    size_t size= 0;
+    uint32_t i;
+
+    if (mariadb_bulk_set_type(col, type, array_size))
+        return 1;
+
+    for (i= 0; i < row_count; i++)
     {
-        return PyTuple_GetItem(obj, index);
+        char buffer[32];
+        char *str= buffer;
+        size_t length;
+        uint8_t rc;
+
+        if (col->indicator[i])
+            continue;
+        if (type == MYSQL_TYPE_DOUBLE)
+        {
+            col->values[i].d= col->is_unsigned ? (double)col->values[i].ull :
+                                                 (double)col->values[i].ll;
+            continue;
+        }
+        if (old_type == MYSQL_TYPE_DOUBLE)
+        {
+            if (!(str= PyOS_double_to_string(col->values[i].d, 'r', 0, 0, NULL)))
+                return 1;
+            length= strlen(str);
+        } else if (col->is_unsigned) {
+            length= snprintf(buffer, sizeof(buffer), "%llu",
+                             (unsigned long long)col->values[i].ull);
+        } else {
+            length= snprintf(buffer, sizeof(buffer), "%lld",
+                             (long long)col->values[i].ll);
+        }
+        rc= mariadb_bulk_store_string(col, i, str, length);
+        if (str != buffer)
+            PyMem_Free(str);
+        if (rc)
+            return 1;
+        size+= length + BULK_LENENC_SIZE(length);
     }
-    /* this should never happen, since the type was checked before */
-    return NULL;
+    if (type == MYSQL_TYPE_NEWDECIMAL)
+        col->size= size;
+    return 0;
 }
+/* }}} */
+
+/* {{{ mariadb_bulk_store_int
+   Stores an integer value and updates the range of the column.
+   Returns 0 on success, 1 if the value can't be represented by a
+   64-bit integer in this column (e.g. negative and unsigned values
+   > 2^63 - 1 are mixed) or -1 on error */
+static int
+mariadb_bulk_store_int(MrdbBulkColumn *col, PyObject *value, uint32_t row_nr)
+{
+    int overflow;
+    long long ll= PyLong_AsLongLongAndOverflow(value, &overflow);
 
-/* 
+    if (overflow > 0)
+    {
+        unsigned long long ull= PyLong_AsUnsignedLongLong(value);
 
-   mariadb_get_parameter()
-   @brief   Returns a bulk parameter which was passed to
-   cursor.executemany() or a parameter which was
-   passed to cursor.execute()
+        if (ull == (unsigned long long)-1 && PyErr_Occurred())
+        {
+            if (!PyErr_ExceptionMatches(PyExc_OverflowError))
+                return -1;
+            PyErr_Clear();
+            return 1;
+        }
+        if (col->min < 0)
+            return 1;
+        col->is_unsigned= 1;
+        if (ull > col->max)
+            col->max= ull;
+        col->values[row_nr].ull= ull;
+        return 0;
+    }
+    if (overflow < 0)
+        return 1;
+    if (ll == -1 && PyErr_Occurred())
+        return -1;
+    if (ll < 0)
+    {
+        if (col->is_unsigned)
+            return 1;
+        if (ll < col->min)
+            col->min= ll;
+    } else if ((uint64_t)ll > col->max)
+        col->max= (uint64_t)ll;
+    col->values[row_nr].ll= ll;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mariadb_bulk_store
+   Infers the type of a parameter value, widens the column type if
+   required and stores the value */
+static uint8_t
+mariadb_bulk_store(MrdbCursor *self, MrdbBulkColumn *col, PyObject *value,
+                   uint32_t row_nr, uint32_t column_nr, Py_ssize_t offset)
+{
+    enum enum_field_types type;
 
-   @param   self[in]         Cursor
-   @param   row_nr[in]       row number
-   @paran   column_nr[in]    column number
-   @param   paran[in][out]   bulk parameter pointer
+    if (value == Py_None)
+    {
+        col->indicator[row_nr]= STMT_INDICATOR_NULL;
+        return 0;
+    }
+
+    if (CHECK_TYPE(value, &PyLong_Type))
+        type= MYSQL_TYPE_LONGLONG;
+    else if (CHECK_TYPE(value, &PyUnicode_Type))
+        type= MYSQL_TYPE_VAR_STRING;
+    else if (CHECK_TYPE(value, &PyFloat_Type))
+        type= MYSQL_TYPE_DOUBLE;
+    else if (CHECK_TYPE(value, &PyBytes_Type))
+        type= MYSQL_TYPE_LONG_BLOB;
+    else if (PyDateTime_CheckExact(value))
+        type= MYSQL_TYPE_DATETIME;
+    else if (PyDate_CheckExact(value))
+        type= MYSQL_TYPE_DATE;
+    else if (PyTime_CheckExact(value) || PyDelta_CheckExact(value))
+        type= MYSQL_TYPE_TIME;
+    else if (MrdbIndicator_Check(value))
+    {
+        if (!MRDB_BULK_SUPPORTED(self->connection))
+        {
+            mariadb_throw_exception(NULL, Mariadb_NotSupportedError, 0,
+                    "MariaDB %s doesn't support indicator variables. "\
+                    "Required version is 10.2.6 or newer",
+                    mysql_get_server_info(self->connection->mysql));
+            return 1;
+        }
+        col->indicator[row_nr]= (char)MrdbIndicator_AsLong(value);
+        return 0;
+    }
+    else if (!strcmp(Py_TYPE(value)->tp_name, "decimal.Decimal") ||
+             !strcmp(Py_TYPE(value)->tp_name, "Decimal"))
+        type= MYSQL_TYPE_NEWDECIMAL;
+    else
+        return mariadb_bulk_type_error(offset + row_nr, column_nr);
+
+    if (col->type != type)
+    {
+        if (col->type == MYSQL_TYPE_NULL)
+        {
+            if (mariadb_bulk_set_type(col, type, self->array_size))
+                return 1;
+        }
+        else if (!BULK_NUMERIC_RANK(type) || !BULK_NUMERIC_RANK(col->type))
+            return mariadb_bulk_type_error(offset + row_nr, column_nr);
+        else if (BULK_NUMERIC_RANK(type) > BULK_NUMERIC_RANK(col->type) &&
+                 mariadb_bulk_widen(col, type, row_nr, self->array_size))
+            return 1;
+    }
+
+    switch (col->type) {
+        case MYSQL_TYPE_LONGLONG:
+            {
+                int rc= mariadb_bulk_store_int(col, value, row_nr);
+
+                if (rc < 0)
+                    return 1;
+                if (!rc)
+                    break;
+                /* out of range: use decimal representation */
+                if (mariadb_bulk_widen(col, MYSQL_TYPE_NEWDECIMAL, row_nr,
+                                       self->array_size))
+                    return 1;
+            }
+            /* fall through */
+        case MYSQL_TYPE_NEWDECIMAL:
+            {
+                PyObject *str;
+                const char *p;
+                Py_ssize_t length;
+                uint8_t rc;
+
+                if (!(str= PyObject_Str(value)))
+                    return 1;
+                if (!(p= PyUnicode_AsUTF8AndSize(str, &length)))
+                {
+                    Py_DECREF(str);
+                    return 1;
+                }
+                rc= mariadb_bulk_store_string(col, row_nr, p, (size_t)length);
+                Py_DECREF(str);
+                if (rc)
+                    return 1;
+            }
+            break;
+        case MYSQL_TYPE_DOUBLE:
+            if (type == MYSQL_TYPE_DOUBLE)
+            {
+                col->values[row_nr].d= PyFloat_AS_DOUBLE(value);
+                break;
+            }
+            if ((col->values[row_nr].d= PyLong_AsDouble(value)) == -1.0 &&
+                PyErr_Occurred())
+            {
+                if (!PyErr_ExceptionMatches(PyExc_OverflowError))
+                    return 1;
+                PyErr_Clear();
+                if (mariadb_bulk_widen(col, MYSQL_TYPE_NEWDECIMAL, row_nr,
+                                       self->array_size))
+                    return 1;
+                return mariadb_bulk_store(self, col, value, row_nr, column_nr,
+                                          offset);
+            }
+            break;
+        case MYSQL_TYPE_VAR_STRING:
+            {
+                Py_ssize_t length;
+
+                if (!(col->values[row_nr].str= PyUnicode_AsUTF8AndSize(value,
+                                                                   &length)))
+                    return 1;
+                col->length[row_nr]= (unsigned long)length;
+            }
+            break;
+        case MYSQL_TYPE_LONG_BLOB:
+            col->values[row_nr].str= PyBytes_AS_STRING(value);
+            col->length[row_nr]= (unsigned long)PyBytes_GET_SIZE(value);
+            break;
+        case MYSQL_TYPE_TIME:
+            if (PyDelta_CheckExact(value))
+            {
+                mariadb_pydelta_to_tm(value, &col->tm[row_nr]);
+                break;
+            }
+            /* fall through */
+        default:
+            mariadb_pydate_to_tm(col->type, value, &col->tm[row_nr]);
+            break;
+    }
+
+    switch (col->type) {
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_DOUBLE:
+            col->size+= 8;
+            break;
+        case MYSQL_TYPE_DATE:
+            col->size+= 5;
+            break;
+        case MYSQL_TYPE_DATETIME:
+            col->size+= 12;
+            break;
+        case MYSQL_TYPE_TIME:
+            col->size+= 13;
+            break;
+        default:
+            col->size+= col->length[row_nr] +
+                        BULK_LENENC_SIZE(col->length[row_nr]);
+            break;
+    }
+    return 0;
+}
+/* }}} */
+
+/* {{{ mariadb_bulk_bind_column
+   Translates the values of a column into the format expected by
+   column-wise binding: Numeric values are stored in an array of the
+   pack length of the (narrowest possible) type, strings, decimals and
+   temporal values are passed as an array of pointers. Since the
+   elements of the converted array are never larger than the elements
+   of the value array, the conversion will be done in place. */
+static void
+mariadb_bulk_bind_column(MrdbBulkColumn *col, MYSQL_BIND *param,
+                         uint32_t array_size)
+{
+    unsigned char *dst= (unsigned char *)col->values;
+    size_t size= 0;
+    uint32_t i;
+
+    param->buffer_type= col->type;
+    param->buffer= col->values;
+    param->length= col->length;
+    param->u.indicator= col->indicator;
+
+    if (col->type == MYSQL_TYPE_LONGLONG)
+    {
+        if (col->is_unsigned)
+            param->is_unsigned= 1;
+        else if (col->min >= INT8_MIN && col->max <= INT8_MAX)
+            param->buffer_type= MYSQL_TYPE_TINY;
+        else if (col->min >= 0 && col->max <= UINT8_MAX)
+            param->buffer_type= MYSQL_TYPE_TINY;
+        else if (col->min >= INT16_MIN && col->max <= INT16_MAX)
+            param->buffer_type= MYSQL_TYPE_SHORT;
+        else if (col->min >= 0 && col->max <= UINT16_MAX)
+            param->buffer_type= MYSQL_TYPE_SHORT;
+        else if (col->min >= INT32_MIN && col->max <= INT32_MAX)
+            param->buffer_type= MYSQL_TYPE_LONG;
+        else if (col->min >= 0 && col->max <= UINT32_MAX)
+            param->buffer_type= MYSQL_TYPE_LONG;
+
+        switch (param->buffer_type) {
+            case MYSQL_TYPE_TINY:
+                size= 1;
+                break;
+            case MYSQL_TYPE_SHORT:
+                size= 2;
+                break;
+            case MYSQL_TYPE_LONG:
+                size= 4;
+                break;
+            default:
+                return;
+        }
+        /* values don't fit into the signed type */
+        if (col->min >= 0 && col->max > (UINT64_C(1) << (size * 8 - 1)) - 1)
+            param->is_unsigned= 1;
+        for (i= 0; i < array_size; i++)
+        {
+            uint64_t val= col->values[i].ull;
+
+            switch (size) {
+                case 1:
+                    dst[i]= (uint8_t)val;
+                    break;
+                case 2:
+                    {
+                        uint16_t s= (uint16_t)val;
+                        memcpy(dst + i * 2, &s, 2);
+                    }
+                    break;
+                default:
+                    {
+                        uint32_t l= (uint32_t)val;
+                        memcpy(dst + i * 4, &l, 4);
+                    }
+                    break;
+            }
+        }
+        return;
+    }
+
+    switch (col->type) {
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_NEWDECIMAL:
+        case MYSQL_TYPE_DATE:
+        case MYSQL_TYPE_TIME:
+        case MYSQL_TYPE_DATETIME:
+            for (i= 0; i < array_size; i++)
+            {
+                const void *p;
+
+                if (col->indicator[i])
+                    p= NULL;
+                else if (col->type == MYSQL_TYPE_NEWDECIMAL)
+                    p= col->arena + col->values[i].offset;
+                else if (col->tm)
+                    p= &col->tm[i];
+                else
+                    p= col->values[i].str;
+                memcpy(dst + i * sizeof(void *), &p, sizeof(void *));
+            }
+            break;
+        default:
+            break;
+    }
+}
+/* }}} */
 
-   @return  0 on success, 1 on error
- */
-static uint8_t 
-mariadb_get_parameter(MrdbCursor *self,
-                      uint8_t is_bulk,
-                      uint32_t row_nr,
-                      uint32_t column_nr,
-                      MrdbParamValue *param)
+/* {{{ mariadb_bulk_grow
+   Enlarges the value and indicator arrays of all columns */
+static uint8_t
+mariadb_bulk_grow(MrdbCursor *self, uint32_t capacity)
 {
-    PyObject *row= NULL,
-             *column= NULL;
-    uint8_t rc= 1;
-    long caps;
+    uint32_t j;
 
-    mariadb_get_infov(self->connection->mysql,
-                      MARIADB_CONNECTION_EXTENDED_SERVER_CAPABILITIES, &caps);
-
-    if (is_bulk)
+    for (j= 0; j < self->parseinfo.paramcount; j++)
     {
-        /* check if row_nr and column_nr are in the range from
-           0 to (value - 1) */
-        if (row_nr > (self->array_size - 1) ||
-                column_nr > (self->parseinfo.paramcount - 1))
+        MrdbBulkColumn *col= &self->bulk[j];
+        void *p;
+
+        if (!(p= PyMem_RawRealloc(col->values, capacity * sizeof(MrdbBulkValue))))
+            goto error;
+        col->values= (MrdbBulkValue *)p;
+        /* values of NULL and indicator rows aren't written, but are read
+           when narrowing integer columns */
+        memset(col->values + self->array_size, 0,
+               (capacity - self->array_size) * sizeof(MrdbBulkValue));
+        if (!(p= PyMem_RawRealloc(col->indicator, capacity)))
+            goto error;
+        col->indicator= (char *)p;
+        memset(col->indicator + self->array_size, 0,
+               capacity - self->array_size);
+        if (col->length)
         {
-            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
-                    "Can't access data at row %d, column %d",
-                     row_nr + 1, column_nr + 1);
-            goto end;
+            if (!(p= PyMem_RawRealloc(col->length,
+                                      capacity * sizeof(unsigned long))))
+                goto error;
+            col->length= (unsigned long *)p;
         }
-
-        if (!(row= ListOrTuple_GetItem(self->data, row_nr)))
+        if (col->tm)
         {
-            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
-                    "Can't access row number %d", row_nr + 1);
-            goto end;
+            if (!(p= PyMem_RawRealloc(col->tm, capacity * sizeof(MYSQL_TIME))))
+                goto error;
+            col->tm= (MYSQL_TIME *)p;
         }
     }
-    else
-        row= self->data;
+    self->array_size= capacity;
+    return 0;
+error:
+    PyErr_NoMemory();
+    return 1;
+}
+/* }}} */
+
+/* {{{ mariadb_bind_bulk_parameters
+   Binds the parameters of cursor.executemany() column-wise: The data
+   is walked once, the column types will be inferred (and widened if
+   required) while the values are stored in contiguous arrays. Sending
+   the data doesn't require further Python calls.
+   Rows will be bound starting at offset until the estimated size of
+   the request exceeds max_bytes (0 = unlimited), at least one row will
+   be bound. On success self->array_size contains the number of bound
+   rows.
+   The arrays will be released by mariadb_free_bulk_parameters(). */
+uint8_t 
+mariadb_bind_bulk_parameters(MrdbCursor *self,
+                             PyObject *data,
+                             Py_ssize_t offset,
+                             size_t max_bytes)
+{
+    uint32_t paramcount= self->parseinfo.paramcount;
+    uint8_t is_dict= (self->parseinfo.paramstyle == PYFORMAT);
+    size_t overhead= BULK_REQUEST_OVERHEAD(paramcount);
+    Py_ssize_t remaining;
+    PyObject **rows;
+    uint32_t i, j;
 
-    if (self->parseinfo.paramstyle != PYFORMAT)
-    {
-        if (!(column= ListOrTuple_GetItem(row, column_nr)))
-        {
-            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
-                    "Can't access column number %d at row %d",
-                     column_nr + 1, row_nr + 1);
-            goto end;
-        }
-    } else
+    if (!CHECK_TYPE((data), &PyList_Type) &&
+        !CHECK_TYPE(data, &PyTuple_Type))
     {
-        PyObject *key;
+        mariadb_throw_exception(self->stmt, Mariadb_InterfaceError, 1, 
+                "Data must be passed as sequence (Tuple or List)");
+        return 1;
+    }
 
-        key= PyTuple_GetItem(self->parseinfo.keys, column_nr);
-        if (!PyDict_Contains(row, key))
-        {
-            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
-                    "Can't find key in parameter data");
-            goto end;
-        }
-        column= PyDict_GetItem(row, key);
+    if ((remaining= PySequence_Fast_GET_SIZE(data) - offset) <= 0)
+    {
+        mariadb_throw_exception(self->stmt, Mariadb_InterfaceError, 1, 
+                "Empty parameter list. At least one row must be specified");
+        return 1;
     }
+    if ((uint64_t)remaining > UINT32_MAX)
+        remaining= UINT32_MAX;
 
-    /* check if an indicator was passed */
-    if (MrdbIndicator_Check(column))
+    if (!paramcount)
     {
-        if (!(caps & (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32)))
-        {
-            mariadb_throw_exception(NULL, Mariadb_NotSupportedError, 0,
-                    "MariaDB %s doesn't support indicator variables. "\
-                    "Required version is 10.2.6 or newer",
-                    mysql_get_server_info(self->stmt->mysql));
-            goto end;
-        }
-        param->indicator= (uint8_t)MrdbIndicator_AsLong(column);
-        param->value= NULL; /* you can't have both indicator and value */
-    } else if (column == Py_None) {
-        param->value= NULL;
-        if (caps &
-            (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32))
-        {
-            param->indicator= STMT_INDICATOR_NULL;
-        }
-    } 
-    else {
-        param->value= column;
-        param->indicator= STMT_INDICATOR_NONE;
+        mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 1, 
+                "Invalid number of parameters in row %d", 1);
+        return 1;
     }
-    rc= 0;
-end:
-    return rc;
-}
 
-/* 
-   mariadb_get_parameter_info
-   mariadb_get_parameter_info fills the MYSQL_BIND structure
-   with correct field_types for the Python objects.
+    mariadb_free_bulk_parameters(self);
+    if (!self->params &&
+        !(self->params= PyMem_RawCalloc(paramcount, sizeof(MYSQL_BIND))))
+        goto nomem;
+    memset(self->params, 0, paramcount * sizeof(MYSQL_BIND));
+
+    /* without limit all rows will be bound, otherwise the arrays grow
+       on demand */
+    self->array_size= (uint32_t)remaining;
+    if (max_bytes && self->array_size > BULK_INITIAL_ROWS)
+        self->array_size= BULK_INITIAL_ROWS;
+
+    if (!(self->bulk= PyMem_RawCalloc(paramcount, sizeof(MrdbBulkColumn))))
+        goto nomem;
+    for (j= 0; j < paramcount; j++)
+    {
+        self->bulk[j].type= MYSQL_TYPE_NULL;
+        if (!(self->bulk[j].values= PyMem_RawCalloc(self->array_size,
+                                                    sizeof(MrdbBulkValue))) ||
+            !(self->bulk[j].indicator= PyMem_RawCalloc(self->array_size, 1)))
+            goto nomem;
+    }
 
-   In case of a bulk operation (executemany()) we will also optimize
-   the field type (e.g. by checking maxbit size for a PyLong).
-   If the types in this column differ we will return an error.
-*/
-static uint8_t 
-mariadb_get_parameter_info(MrdbCursor *self,
-                           MYSQL_BIND *param,
-                           uint32_t column_nr)
-{
-    uint32_t i, bits= 0;
-    MrdbParamValue paramvalue;
-    MrdbParamInfo pinfo;
+    rows= PySequence_Fast_ITEMS(data) + offset;
+    for (i= 0; i < (uint32_t)remaining; i++)
+    {
+        PyObject *row= rows[i];
+        PyObject **items= NULL;
 
-    param->is_unsigned= 0;
-    paramvalue.indicator= 0;
+        if (i == self->array_size &&
+            mariadb_bulk_grow(self, (uint32_t)remaining / 2 > i ? i * 2 :
+                                    (uint32_t)remaining))
+            goto error;
 
-    if (!self->array_size)
-    {
-        uint8_t rc;
-        memset(&pinfo, 0, sizeof(MrdbParamInfo));
-        if (mariadb_get_parameter(self, 0, 0, column_nr, &paramvalue))
-            return 1;
-        if ((rc= mariadb_get_column_info(paramvalue.value, &pinfo)))
+        if (is_dict)
         {
-            if (rc == 1)
+            if (!CHECK_TYPE(row, &PyDict_Type))
             {
                 mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
-                    "Can't retrieve column information for parameter %d",
-                     column_nr);
+                        "Invalid parameter type in row %zd. "\
+                        " (Row data must be provided as dict)", offset + i + 1);
+                goto error;
             }
-            if (rc == 2)
+        } else {
+            if (!CHECK_TYPE(row, &PyTuple_Type) &&
+                !CHECK_TYPE(row, &PyList_Type))
             {
-                mariadb_throw_exception(NULL, Mariadb_NotSupportedError, 0,
-                    "Data type '%s' in column %d not supported in MariaDB Connector/Python",
-                     Py_TYPE(paramvalue.value)->tp_name, column_nr);
+                mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                        "Invalid parameter type in row %zd. "\
+                        " (Row data must be provided as tuple(s))", offset + i + 1);
+                goto error;
             }
-       
-            return 1;
-        }
-        param->buffer_type= pinfo.type;
-        bits= (uint32_t)pinfo.bits;
-    }
-    else for (i=0; i < self->array_size; i++)
-    {
-        if (mariadb_get_parameter(self, 1, i, column_nr, &paramvalue))
-            return 1;
-        memset(&pinfo, 0, sizeof(MrdbParamInfo));
-        if (mariadb_get_column_info(paramvalue.value, &pinfo) && !paramvalue.indicator)
-        {
-            mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 1,
-                    "Invalid parameter type at row %d, column %d",
-                    i+1, column_nr + 1);
-            return 1;
+            if (PySequence_Fast_GET_SIZE(row) != paramcount)
+            {
+                mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 1, 
+                        "Invalid number of parameters in row %zd", offset + i + 1);
+                goto error;
+            }
+            items= PySequence_Fast_ITEMS(row);
         }
 
-        if (pinfo.type == MYSQL_TYPE_LONGLONG)
+        for (j= 0; j < paramcount; j++)
         {
-            uint64_t tmp= PyLong_AsLongLong(paramvalue.value);
+            PyObject *value;
 
-            if (tmp == (uint64_t)-1 && PyErr_Occurred)
-            {
-              param->is_unsigned= 1;
-              PyErr_Clear();
-            }
-            if (pinfo.bits > bits)
+            if (items)
+                value= items[j];
+            else if (!(value= PyDict_GetItemWithError(row,
+                                  PyTuple_GET_ITEM(self->parseinfo.keys, j))))
             {
-                bits= (uint32_t)pinfo.bits;
+                if (!PyErr_Occurred())
+                    mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 0,
+                            "Can't find key in parameter data");
+                goto error;
             }
-
+            if (mariadb_bulk_store(self, &self->bulk[j], value, i, j, offset))
+                goto error;
         }
 
-        if (!param->buffer_type ||
-                param->buffer_type == MYSQL_TYPE_NULL)
+        /* indicator bytes and values: if the row doesn't fit, it will
+           be sent with the next request */
+        if (max_bytes && i)
         {
-            param->buffer_type= pinfo.type;
+            size_t size= overhead + (size_t)(i + 1) * paramcount;
+
+            for (j= 0; j < paramcount; j++)
+                size+= self->bulk[j].size;
+            if (size > max_bytes)
+                break;
         }
-        else {
-            /* except for NULL the parameter types must match */
-            if (param->buffer_type != pinfo.type &&
-                    pinfo.type != MYSQL_TYPE_NULL &&
-                    !paramvalue.indicator)
-            {
-                if ((param->buffer_type == MYSQL_TYPE_TINY ||
-                     param->buffer_type == MYSQL_TYPE_SHORT ||
-                     param->buffer_type == MYSQL_TYPE_LONG) &&
-                        pinfo.type == MYSQL_TYPE_LONGLONG)
-                    break;
-                if (IS_DECIMAL_TYPE(pinfo.type) &&
-                    IS_DECIMAL_TYPE(param->buffer_type))
-                {
-                    param->buffer_type= MYSQL_TYPE_NEWDECIMAL;
-                    break;
-                }
-                mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 1,
-                        "Invalid parameter type at row %d, column %d",
-                        i+1, column_nr + 1);
+    }
+
+    self->array_size= i;
+    for (j= 0; j < paramcount; j++)
+        mariadb_bulk_bind_column(&self->bulk[j], &self->params[j],
+                                 self->array_size);
+    return 0;
+nomem:
+    PyErr_NoMemory();
+error:
+    mariadb_free_bulk_parameters(self);
+    return 1;
+}
+/* }}} */
+
+/* {{{ mariadb_bulk_buffer_type
+   Translates the format of a buffer object into the field type of the
+   bind structure. Returns 1 if the format is not supported */
+static uint8_t
+mariadb_bulk_buffer_type(Py_buffer *view, MYSQL_BIND *param)
+{
+    const char *format= view->format ? view->format : "B";
+    uint16_t one= 1;
+    uint8_t is_little_endian= *(uint8_t *)&one;
+
+    /* byte order must match the native byte order */
+    switch (*format) {
+        case '@':
+        case '=':
+            format++;
+            break;
+        case '<':
+            if (!is_little_endian)
                 return 1;
-            }
-        }
+            format++;
+            break;
+        case '>':
+        case '!':
+            if (is_little_endian)
+                return 1;
+            format++;
+            break;
+        default:
+            break;
     }
-    /* check the bit size for long types and set the appropriate
-       field type */
-    if (param->buffer_type == MYSQL_TYPE_LONGLONG)
-    {
-        if ((bits <= 8 && param->is_unsigned) || bits < 8)
-        {
+    if (!*format || format[1])
+        return 1;
+
+    param->is_unsigned= 0;
+    switch (*format) {
+        case 'f':
+        case 'd':
+            if (view->itemsize == 4)
+                param->buffer_type= MYSQL_TYPE_FLOAT;
+            else if (view->itemsize == 8)
+                param->buffer_type= MYSQL_TYPE_DOUBLE;
+            else
+                return 1;
+            return 0;
+        case 'B':
+        case 'H':
+        case 'I':
+        case 'L':
+        case 'Q':
+        case 'N':
+            param->is_unsigned= 1;
+            break;
+        case 'b':
+        case 'h':
+        case 'i':
+        case 'l':
+        case 'q':
+        case 'n':
+        case '?':
+            break;
+        default:
+            return 1;
+    }
+
+    switch (view->itemsize) {
+        case 1:
             param->buffer_type= MYSQL_TYPE_TINY;
-        }
-        else if ((bits <= 16 && param->is_unsigned) || bits < 16) {
+            break;
+        case 2:
             param->buffer_type= MYSQL_TYPE_SHORT;
-        }
-        else if ((bits <= 32 && param->is_unsigned) || bits < 32) {
+            break;
+        case 4:
             param->buffer_type= MYSQL_TYPE_LONG;
-        }
-        else {
+            break;
+        case 8:
             param->buffer_type= MYSQL_TYPE_LONGLONG;
-        }
+            break;
+        default:
+            return 1;
     }
     return 0;
 }
-
-static Py_ssize_t ListOrTuple_Size(PyObject *obj)
+/* }}} */
+
+/* {{{ mariadb_bind_bulk_columns
+   Binds columnar parameters of cursor.executemany(): data is a sequence
+   of (values, null mask) tuples in placeholder order. Values and null
+   masks are one-dimensional objects which support the buffer protocol
+   (e.g. array.array, memoryview or NumPy arrays), the bind structures
+   point to their memory, so no Python objects will be created per row.
+   Rows will be bound starting at offset, the number of rows is limited
+   by max_bytes (0 = unlimited) and stored in self->array_size.
+   The buffers will be released by mariadb_free_bulk_parameters(). */
+uint8_t
+mariadb_bind_bulk_columns(MrdbCursor *self, PyObject *data,
+                          Py_ssize_t offset, size_t max_bytes)
 {
-    if (CHECK_TYPE(obj, &PyList_Type))
-    {
-        return PyList_Size(obj);
-    } else if (CHECK_TYPE(obj, &PyTuple_Type))
+    uint32_t paramcount= self->parseinfo.paramcount;
+    size_t overhead= BULK_REQUEST_OVERHEAD(paramcount);
+    size_t row_size= 0;
+    Py_ssize_t i, rows= -1;
+    uint32_t j;
+
+    if ((!CHECK_TYPE(data, &PyList_Type) && !CHECK_TYPE(data, &PyTuple_Type)) ||
+        !paramcount || PySequence_Fast_GET_SIZE(data) != paramcount)
     {
-        return PyTuple_Size(obj);
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Number of columns doesn't match the number of parameters");
+        return 1;
     }
-    /* this should never happen, since the type was checked before */
-    return 0;
-}
 
-/* mariadb_check_bulk_parameters
-   This function validates the specified bulk parameters and
-   translates the field types to MYSQL_TYPE_*.
- */
-uint8_t 
-mariadb_check_bulk_parameters(MrdbCursor *self,
-                              PyObject *data)
-{
-    uint32_t i;
+    mariadb_free_bulk_parameters(self);
+    if (!self->params &&
+        !(self->params= PyMem_RawCalloc(paramcount, sizeof(MYSQL_BIND))))
+        goto nomem;
+    memset(self->params, 0, paramcount * sizeof(MYSQL_BIND));
 
-    if (!CHECK_TYPE((data), &PyList_Type) &&
-        !CHECK_TYPE(data, &PyTuple_Type))
-    {
-        mariadb_throw_exception(self->stmt, Mariadb_InterfaceError, 1, 
-                "Data must be passed as sequence (Tuple or List)");
-        return 1;
-    }
+    if (!(self->bulk= PyMem_RawCalloc(paramcount, sizeof(MrdbBulkColumn))))
+        goto nomem;
 
-    if (!(self->array_size= (uint32_t)ListOrTuple_Size(data)))
+    for (j= 0; j < paramcount; j++)
     {
-        mariadb_throw_exception(self->stmt, Mariadb_InterfaceError, 1, 
-                "Empty parameter list. At least one row must be specified");
-        return 1;
-    }
+        MrdbBulkColumn *col= &self->bulk[j];
+        PyObject *column= PySequence_Fast_GET_ITEM(data, j);
 
-    for (i=0; i < self->array_size; i++)
-    {
-        PyObject *obj= ListOrTuple_GetItem(data, i);
-        if (self->parseinfo.paramstyle != PYFORMAT &&
-                (!CHECK_TYPE(obj, &PyTuple_Type) &&
-                 !CHECK_TYPE(obj, &PyList_Type)))
+        if (PyObject_GetBuffer(PyTuple_GET_ITEM(column, 0), &col->view,
+                               PyBUF_C_CONTIGUOUS | PyBUF_FORMAT))
         {
-            mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
-                    "Invalid parameter type in row %d. "\
-                    " (Row data must be provided as tuple(s))", i+1);
-            return 1;
+            col->view.obj= NULL;
+            goto error;
+        }
+        if (col->view.ndim != 1 ||
+            mariadb_bulk_buffer_type(&col->view, &self->params[j]))
+        {
+            mariadb_throw_exception(NULL, Mariadb_NotSupportedError, 0,
+                    "Unsupported buffer format '%s' in column %d",
+                    col->view.format ? col->view.format : "B", j + 1);
+            goto error;
         }
-        if (self->parseinfo.paramstyle == PYFORMAT &&
-                !CHECK_TYPE(obj, &PyDict_Type))
+        if (rows < 0)
+            rows= col->view.shape[0];
+        else if (col->view.shape[0] != rows)
         {
             mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
-                    "Invalid parameter type in row %d. "\
-                    " (Row data must be provided as dict)", i+1);
-            return 1;
+                    "Column %d contains %zd rows, expected %zd rows",
+                    j + 1, col->view.shape[0], rows);
+            goto error;
         }
+        /* indicator byte and value */
+        row_size+= col->view.itemsize + 1;
+
+        if (PyTuple_GET_ITEM(column, 1) == Py_None)
+            continue;
 
-        if (!self->parseinfo.paramcount ||
-                (self->parseinfo.paramstyle != PYFORMAT && 
-                 self->parseinfo.paramcount != ListOrTuple_Size(obj)))
+        if (PyObject_GetBuffer(PyTuple_GET_ITEM(column, 1), &col->mask,
+                               PyBUF_C_CONTIGUOUS | PyBUF_FORMAT))
         {
-            mariadb_throw_exception(self->stmt, Mariadb_ProgrammingError, 1, 
-                    "Invalid number of parameters in row %d", i+1);
-            return 1;
+            col->mask.obj= NULL;
+            goto error;
+        }
+        if (col->mask.ndim != 1 || col->mask.itemsize != 1 ||
+            col->mask.shape[0] != rows)
+        {
+            mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                    "Null mask of column %d doesn't match the column data",
+                    j + 1);
+            goto error;
         }
     }
 
-    if (!self->is_prepared &&
-            !(self->params= PyMem_RawCalloc(self->parseinfo.paramcount,
-                                            sizeof(MYSQL_BIND))))
+    if ((rows-= offset) <= 0)
     {
         mariadb_throw_exception(NULL, Mariadb_InterfaceError, 0,
-                "Not enough memory (tried to allocated %lld bytes)",
-                self->parseinfo.paramcount * sizeof(MYSQL_BIND));
+                "Empty parameter list. At least one row must be specified");
         goto error;
     }
-
-    if (!(self->value= PyMem_RawCalloc(self->parseinfo.paramcount, 
-                                       sizeof(MrdbParamValue))))
+    if (max_bytes)
     {
-        mariadb_throw_exception(NULL, Mariadb_InterfaceError, 0,
-                "Not enough memory (tried to allocated %lld bytes)",
-                self->parseinfo.paramcount * sizeof(MrdbParamValue));
-        goto error;
+        size_t max_rows= max_bytes > overhead + row_size ?
+                         (max_bytes - overhead) / row_size : 1;
+
+        if ((size_t)rows > max_rows)
+            rows= (Py_ssize_t)max_rows;
     }
+    if ((uint64_t)rows > UINT32_MAX)
+        rows= UINT32_MAX;
+    self->array_size= (uint32_t)rows;
 
-    for (i=0; i < self->parseinfo.paramcount; i++)
+    for (j= 0; j < paramcount; j++)
     {
-        if (mariadb_get_parameter_info(self, &self->params[i], i))
-            goto error;
+        MrdbBulkColumn *col= &self->bulk[j];
+        MYSQL_BIND *param= &self->params[j];
+        unsigned char *mask;
+
+        param->buffer= (char *)col->view.buf + offset * col->view.itemsize;
+        if (!col->mask.obj)
+            continue;
+
+        /* boolean masks can be used as indicator array, other non zero
+           values need to be translated */
+        mask= (unsigned char *)col->mask.buf + offset;
+        param->u.indicator= (char *)mask;
+        for (i= 0; i < rows && mask[i] <= STMT_INDICATOR_NULL; i++);
+        if (i < rows)
+        {
+            if (!(col->indicator= PyMem_RawMalloc(rows)))
+                goto nomem;
+            for (i= 0; i < rows; i++)
+                col->indicator[i]= mask[i] ? STMT_INDICATOR_NULL :
+                                             STMT_INDICATOR_NONE;
+            param->u.indicator= col->indicator;
+        }
     }
     return 0;
+nomem:
+    PyErr_NoMemory();
 error:
-    MARIADB_FREE_MEM(self->paraminfo);
-    MARIADB_FREE_MEM(self->value);
+    mariadb_free_bulk_parameters(self);
     return 1;
 }
+/* }}} */
+
+/* {{{ mariadb_free_bulk_parameters */
+void
+mariadb_free_bulk_parameters(MrdbCursor *self)
+{
+    uint32_t i;
+
+    if (!self->bulk)
+        return;
+
+    for (i= 0; i < self->parseinfo.paramcount; i++)
+    {
+        MARIADB_FREE_MEM(self->bulk[i].values);
+        MARIADB_FREE_MEM(self->bulk[i].length);
+        MARIADB_FREE_MEM(self->bulk[i].indicator);
+        MARIADB_FREE_MEM(self->bulk[i].tm);
+        MARIADB_FREE_MEM(self->bulk[i].arena);
+        PyBuffer_Release(&self->bulk[i].view);
+        PyBuffer_Release(&self->bulk[i].mask);
+    }
+    MARIADB_FREE_MEM(self->bulk);
+    /* bind buffers point to the released arrays */
+    if (self->params)
+        memset(self->params, 0, self->parseinfo.paramcount * sizeof(MYSQL_BIND));
+}
+/* }}} */
 
 uint8_t
 mariadb_check_execute_parameters(MrdbCursor *self,
@@ -0,0 +1,687 @@
+/*****************************************************************************
+  Copyright (C) 2018-2020 Georg Richter and MariaDB Corporation AB
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+ ****************************************************************************/
+#include "mariadb_python.h"
+#include "docs/columns.h"
+
+#define COLUMN_BUFFER_INITIAL_ROWS 64
+#define USEC_PER_SEC 1000000LL
+#define USEC_PER_DAY (86400LL * USEC_PER_SEC)
+
+static const char *column_buffer_type_names[]= {
+    "int64", "uint64", "double", "date32", "timestamp[us]", "duration[us]",
+    "utf8", "binary", "decimal128"};
+
+static const char *column_buffer_formats[]= {
+    "q", "Q", "d", "i", "q", "q", "B", "B", "16s"};
+
+/* Max. precision of decimal128 values */
+#define DECIMAL128_MAX_PRECISION 38
+
+/* {{{ mrdb_days_from_civil
+   Returns the number of days since 1970-01-01 for a date of the
+   proleptic gregorian calendar */
+static int32_t
+mrdb_days_from_civil(int year, unsigned int month, unsigned int day)
+{
+    int era;
+    unsigned int yoe, doy, doe;
+
+    year-= (month <= 2);
+    era= (year >= 0 ? year : year - 399) / 400;
+    yoe= (unsigned int)(year - era * 400);
+    doy= (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    doe= yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int32_t)(era * 146097 + (int)doe - 719468);
+}
+/* }}} */
+
+/* {{{ MrdbColumnBuffer_New
+   Creates an empty column buffer for the specified column of the
+   column plan. If decimal128 is set, DECIMAL values with a precision
+   up to 38 digits are stored as 128-bit integers, otherwise as strings */
+PyObject *
+MrdbColumnBuffer_New(MrdbColumnPlan *plan, uint32_t column,
+                     MYSQL_FIELD *field, uint8_t decimal128)
+{
+    MrdbColumnBuffer *self;
+    MrdbColumn *col= &plan->columns[column];
+
+    if (!(self= PyObject_New(MrdbColumnBuffer, &MrdbColumnBuffer_Type)))
+        return NULL;
+
+    self->field_type= col->type;
+    self->is_unsigned= col->is_unsigned;
+    self->is_text= plan->is_text;
+    self->length= self->null_count= 0;
+    self->data= NULL;
+    self->data_length= self->data_size= 0;
+    self->validity= NULL;
+    self->validity_size= 0;
+    self->offsets= NULL;
+    self->offsets_size= 0;
+    self->scale= col->decimals;
+    /* length of DECIMAL columns includes sign and decimal point */
+    self->precision= (unsigned int)field->length - (col->is_unsigned ? 0 : 1) -
+                     (col->decimals ? 1 : 0);
+
+    switch (col->type) {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_YEAR:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+            self->type= COLUMN_BUFFER_INT64;
+            break;
+        case MYSQL_TYPE_LONGLONG:
+            self->type= col->is_unsigned ? COLUMN_BUFFER_UINT64 :
+                                           COLUMN_BUFFER_INT64;
+            break;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+            self->type= COLUMN_BUFFER_DOUBLE;
+            break;
+        case MYSQL_TYPE_DATE:
+        case MYSQL_TYPE_NEWDATE:
+            self->type= COLUMN_BUFFER_DATE32;
+            break;
+        case MYSQL_TYPE_DATETIME:
+        case MYSQL_TYPE_TIMESTAMP:
+            self->type= COLUMN_BUFFER_TIMESTAMP;
+            break;
+        case MYSQL_TYPE_TIME:
+            self->type= COLUMN_BUFFER_DURATION;
+            break;
+        case MYSQL_TYPE_NEWDECIMAL:
+            if (decimal128 && self->precision <= DECIMAL128_MAX_PRECISION)
+            {
+                self->type= COLUMN_BUFFER_DECIMAL128;
+                break;
+            }
+            /* fall through */
+        default:
+            /* strings, decimals, blobs and all other types */
+            self->type= (col->is_binary && col->ext_type != EXT_TYPE_JSON &&
+                         col->type != MYSQL_TYPE_NEWDECIMAL) ?
+                        COLUMN_BUFFER_BINARY : COLUMN_BUFFER_UTF8;
+            break;
+    }
+
+    switch (self->type) {
+        case COLUMN_BUFFER_DATE32:
+            self->item_size= sizeof(int32_t);
+            break;
+        case COLUMN_BUFFER_DECIMAL128:
+            self->item_size= 16;
+            break;
+        case COLUMN_BUFFER_UTF8:
+        case COLUMN_BUFFER_BINARY:
+            self->item_size= 0;
+            break;
+        default:
+            self->item_size= 8;
+    }
+
+    if (!(self->name= PyUnicode_FromString(field->name)))
+    {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+/* }}} */
+
+/* {{{ mrdb_column_buffer_reserve
+   Makes sure that there is space for one more value with the specified
+   (variable) length */
+static uint8_t
+mrdb_column_buffer_reserve(MrdbColumnBuffer *self, size_t length)
+{
+    size_t rows= (size_t)self->length + 1;
+
+    if (rows > self->validity_size * 8)
+    {
+        size_t size= self->validity_size ? self->validity_size * 2 :
+                                           COLUMN_BUFFER_INITIAL_ROWS / 8;
+        uint8_t *validity;
+
+        if (!(validity= (uint8_t *)PyMem_RawRealloc(self->validity, size)))
+            goto error;
+        memset(validity + self->validity_size, 0, size - self->validity_size);
+        self->validity= validity;
+        self->validity_size= size;
+    }
+
+    if (!self->item_size)
+    {
+        if (rows + 1 > self->offsets_size)
+        {
+            size_t size= self->offsets_size ? self->offsets_size * 2 :
+                                              COLUMN_BUFFER_INITIAL_ROWS + 1;
+            int64_t *offsets;
+
+            if (!(offsets= (int64_t *)PyMem_RawRealloc(self->offsets,
+                                                        size * sizeof(int64_t))))
+                goto error;
+            if (!self->offsets_size)
+                offsets[0]= 0;
+            self->offsets= offsets;
+            self->offsets_size= size;
+        }
+    } else
+        length= self->item_size;
+
+    if (self->data_length + length > self->data_size)
+    {
+        size_t size= self->data_size ? self->data_size * 2 :
+                     COLUMN_BUFFER_INITIAL_ROWS * (self->item_size ?
+                                                   self->item_size : 16);
+        unsigned char *data;
+
+        while (size < self->data_length + length)
+            size*= 2;
+        if (!(data= (unsigned char *)PyMem_RawRealloc(self->data, size)))
+            goto error;
+        self->data= data;
+        self->data_size= size;
+    }
+    return 0;
+error:
+    PyErr_NoMemory();
+    return 1;
+}
+/* }}} */
+
+/* {{{ mrdb_text_to_int64
+   Converts the text representation of an integer, returns 1 if the value
+   is not a valid number or doesn't fit */
+static uint8_t
+mrdb_text_to_int64(const unsigned char *p, unsigned long length,
+                   uint8_t is_unsigned, int64_t *value)
+{
+    const unsigned char *end= p + length;
+    uint8_t neg= 0;
+    uint64_t val= 0;
+
+    if (p < end && *p == '-')
+    {
+        neg= 1;
+        p++;
+    }
+    if (p == end)
+        return 1;
+    for (; p < end; p++)
+    {
+        unsigned int digit= *p - '0';
+
+        if (digit > 9 || val > (UINT64_MAX - digit) / 10)
+            return 1;
+        val= val * 10 + digit;
+    }
+    if (is_unsigned)
+    {
+        if (neg && val)
+            return 1;
+        *value= (int64_t)val;
+        return 0;
+    }
+    if (neg)
+    {
+        if (val > (uint64_t)INT64_MAX + 1)
+            return 1;
+        *value= val ? -(int64_t)(val - 1) - 1 : 0;
+        return 0;
+    }
+    if (val > INT64_MAX)
+        return 1;
+    *value= (int64_t)val;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_column_buffer_temporal
+   Reads date and time values into tm, returns 1 for invalid
+   (e.g. zero) dates */
+static uint8_t
+mrdb_column_buffer_temporal(MrdbColumnBuffer *self, MrdbRawValue *raw,
+                            MYSQL_TIME *tm)
+{
+    memset(tm, 0, sizeof(MYSQL_TIME));
+
+    if (self->is_text)
+    {
+        if (Py_str_to_TIME((const char *)raw->data, raw->length, tm))
+            return 1;
+    } else
+    {
+        unsigned char *p= raw->data + 1;
+        uint8_t len= raw->data[0];
+
+        if (self->type == COLUMN_BUFFER_DURATION)
+        {
+            if (len)
+            {
+                tm->neg= p[0];
+                tm->day= uint4korr(p + 1);
+                tm->hour= p[5];
+                tm->minute= p[6];
+                tm->second= p[7];
+                if (len > 8)
+                    tm->second_part= uint4korr(p + 8);
+            }
+            return 0;
+        }
+        if (len)
+        {
+            tm->year= uint2korr(p);
+            tm->month= p[2];
+            tm->day= p[3];
+        }
+        if (len > 4)
+        {
+            tm->hour= p[4];
+            tm->minute= p[5];
+            tm->second= p[6];
+        }
+        if (len == 11)
+            tm->second_part= uint4korr(p + 7);
+    }
+    if (self->type != COLUMN_BUFFER_DURATION && (!tm->month || !tm->day))
+        return 1;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_text_to_decimal128
+   Converts the text representation of a decimal value into an unscaled
+   128-bit integer (native byte order) with the specified scale */
+static uint8_t
+mrdb_text_to_decimal128(const unsigned char *p, unsigned long length,
+                        unsigned int scale, unsigned char *value)
+{
+    const unsigned char *end= p + length;
+    uint64_t lo= 0, hi= 0;
+    uint8_t neg= 0, in_fraction= 0;
+    unsigned int digits= 0, fraction_digits= 0;
+
+    if (p < end && (*p == '-' || *p == '+'))
+        neg= (*p++ == '-');
+
+    for (;; p++)
+    {
+        unsigned int digit;
+        uint64_t lo8, lo2, carry;
+
+        if (p < end && *p == '.' && !in_fraction)
+        {
+            in_fraction= 1;
+            continue;
+        }
+        if (p < end)
+        {
+            if ((digit= *p - '0') > 9)
+                return 1;
+            /* ignore additional fractional digits */
+            if (in_fraction && fraction_digits == scale)
+                continue;
+        } else
+        {
+            /* pad fractional part */
+            if (fraction_digits >= scale)
+                break;
+            digit= 0;
+            in_fraction= 1;
+        }
+        /* leading zeros don't count towards the precision */
+        if ((digits || digit) && ++digits > DECIMAL128_MAX_PRECISION)
+            return 1;
+        if (in_fraction)
+            fraction_digits++;
+
+        /* value= value * 10 + digit */
+        lo8= lo << 3;
+        lo2= lo << 1;
+        hi= (hi << 3 | lo >> 61) + (hi << 1 | lo >> 63);
+        lo= lo8 + lo2;
+        hi+= (lo < lo8);
+        carry= lo;
+        lo+= digit;
+        hi+= (lo < carry);
+    }
+
+    if (neg)
+    {
+        lo= ~lo + 1;
+        hi= ~hi + (lo == 0);
+    }
+#ifdef WORDS_BIGENDIAN
+    memcpy(value, &hi, 8);
+    memcpy(value + 8, &lo, 8);
+#else
+    memcpy(value, &lo, 8);
+    memcpy(value + 8, &hi, 8);
+#endif
+    return 0;
+}
+/* }}} */
+
+/* {{{ MrdbColumnBuffer_Append
+   Converts a raw value and appends it to the column buffer.
+   Values which can't be converted (e.g. zero dates) are stored as NULL.
+
+   Returns 0 on success, 1 on error (exception is set) */
+uint8_t
+MrdbColumnBuffer_Append(MrdbColumnBuffer *self, MrdbRawValue *raw)
+{
+    unsigned char *data= raw->data;
+    unsigned long length= raw->length;
+    unsigned char *p;
+    uint8_t is_null= (data == NULL);
+    MYSQL_TIME tm;
+
+    if (data && !self->is_text && self->type >= COLUMN_BUFFER_UTF8)
+    {
+        /* binary protocol: skip length prefix */
+        p= data;
+        length= mysql_net_field_length(&p);
+        data= p;
+    }
+
+    if (mrdb_column_buffer_reserve(self, is_null ? 0 : length))
+        return 1;
+
+    p= self->data + self->data_length;
+
+    if (is_null)
+    {
+        if (self->item_size)
+            memset(p, 0, self->item_size);
+        goto end;
+    }
+
+    switch (self->type) {
+        case COLUMN_BUFFER_INT64:
+        case COLUMN_BUFFER_UINT64:
+        {
+            int64_t val= 0;
+
+            if (self->is_text)
+            {
+                if (mrdb_text_to_int64(data, length,
+                                       self->type == COLUMN_BUFFER_UINT64,
+                                       &val))
+                {
+                    PyErr_Format(PyExc_OverflowError,
+                                 "Value '%.*s' doesn't fit into %s column",
+                                 (int)length, data,
+                                 column_buffer_type_names[self->type]);
+                    return 1;
+                }
+            } else
+            {
+                switch (self->field_type) {
+                    case MYSQL_TYPE_TINY:
+                        val= self->is_unsigned ? (int64_t)data[0] :
+                                                 (int64_t)(int8_t)data[0];
+                        break;
+                    case MYSQL_TYPE_SHORT:
+                    case MYSQL_TYPE_YEAR:
+                        val= self->is_unsigned ? (int64_t)uint2korr(data) :
+                                                 (int64_t)sint2korr(data);
+                        break;
+                    case MYSQL_TYPE_INT24:
+                        val= self->is_unsigned ? (int64_t)uint3korr(data) :
+                                                 (int64_t)sint3korr(data);
+                        break;
+                    case MYSQL_TYPE_LONG:
+                        val= self->is_unsigned ? (int64_t)uint4korr(data) :
+                                                 (int64_t)sint4korr(data);
+                        break;
+                    default:
+                        val= (int64_t)sint8korr(data);
+                }
+            }
+            memcpy(p, &val, sizeof(int64_t));
+            break;
+        }
+        case COLUMN_BUFFER_DOUBLE:
+        {
+            double d;
+
+            if (self->is_text)
+            {
+                d= PyOS_string_to_double((const char *)data, NULL, NULL);
+                if (d == -1.0 && PyErr_Occurred())
+                    return 1;
+            } else if (self->field_type == MYSQL_TYPE_FLOAT)
+            {
+                float f;
+
+                float4get(f, data);
+                d= (double)f;
+            } else
+                float8get(d, data);
+            memcpy(p, &d, sizeof(double));
+            break;
+        }
+        case COLUMN_BUFFER_DECIMAL128:
+            if (mrdb_text_to_decimal128(data, length, self->scale, p))
+            {
+                PyErr_Format(PyExc_OverflowError,
+                             "Value '%.*s' doesn't fit into decimal128 column",
+                             (int)length, data);
+                return 1;
+            }
+            break;
+        case COLUMN_BUFFER_DATE32:
+        {
+            int32_t days;
+
+            if ((is_null= mrdb_column_buffer_temporal(self, raw, &tm)))
+            {
+                memset(p, 0, self->item_size);
+                break;
+            }
+            days= mrdb_days_from_civil(tm.year, tm.month, tm.day);
+            memcpy(p, &days, sizeof(int32_t));
+            break;
+        }
+        case COLUMN_BUFFER_TIMESTAMP:
+        case COLUMN_BUFFER_DURATION:
+        {
+            int64_t usec;
+
+            if ((is_null= mrdb_column_buffer_temporal(self, raw, &tm)))
+            {
+                memset(p, 0, self->item_size);
+                break;
+            }
+            usec= ((int64_t)tm.hour * 3600 + tm.minute * 60 + tm.second) *
+                  USEC_PER_SEC + tm.second_part;
+            if (self->type == COLUMN_BUFFER_TIMESTAMP)
+                usec+= mrdb_days_from_civil(tm.year, tm.month, tm.day) *
+                       USEC_PER_DAY;
+            else
+            {
+                usec+= tm.day * USEC_PER_DAY;
+                if (tm.neg)
+                    usec= -usec;
+            }
+            memcpy(p, &usec, sizeof(int64_t));
+            break;
+        }
+        default:
+            memcpy(p, data, length);
+            self->data_length+= length;
+            break;
+    }
+
+end:
+    if (self->item_size)
+        self->data_length+= self->item_size;
+    else
+        self->offsets[self->length + 1]= (int64_t)self->data_length;
+    if (is_null)
+        self->null_count++;
+    else
+        self->validity[self->length / 8]|= (uint8_t)(1 << (self->length % 8));
+    self->length++;
+    return 0;
+}
+/* }}} */
+
+/* {{{ MrdbColumnBuffer_dealloc */
+static void
+MrdbColumnBuffer_dealloc(MrdbColumnBuffer *self)
+{
+    Py_XDECREF(self->name);
+    MARIADB_FREE_MEM(self->data);
+    MARIADB_FREE_MEM(self->validity);
+    MARIADB_FREE_MEM(self->offsets);
+    PyObject_Del(self);
+}
+/* }}} */
+
+/* {{{ MrdbColumnBuffer_getbuffer
+   Exports the values of fixed size columns, or the data of variable
+   length columns */
+static int
+MrdbColumnBuffer_getbuffer(MrdbColumnBuffer *self, Py_buffer *view, int flags)
+{
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "Column buffer is read-only");
+        view->obj= NULL;
+        return -1;
+    }
+    view->obj= (PyObject *)self;
+    Py_INCREF(self);
+    view->buf= self->data ? self->data : (void *)"";
+    view->len= (Py_ssize_t)(self->item_size ? self->length * self->item_size :
+                                              self->data_length);
+    view->readonly= 1;
+    view->itemsize= self->item_size ? self->item_size : 1;
+    view->format= (flags & PyBUF_FORMAT) ?
+                  (char *)column_buffer_formats[self->type] : NULL;
+    view->ndim= 1;
+    view->shape= NULL;
+    if ((flags & PyBUF_ND) == PyBUF_ND)
+    {
+        self->shape= view->len / view->itemsize;
+        view->shape= &self->shape;
+    }
+    view->strides= ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ?
+                   &view->itemsize : NULL;
+    view->suboffsets= NULL;
+    view->internal= NULL;
+    return 0;
+}
+/* }}} */
+
+static Py_ssize_t
+MrdbColumnBuffer_length(MrdbColumnBuffer *self)
+{
+    return self->length;
+}
+
+static PyObject *
+MrdbColumnBuffer_get_type(MrdbColumnBuffer *self, void *closure)
+{
+    return PyUnicode_FromString(column_buffer_type_names[self->type]);
+}
+
+static PyObject *
+MrdbColumnBuffer_get_validity(MrdbColumnBuffer *self, void *closure)
+{
+    return PyBytes_FromStringAndSize(self->validity ? (char *)self->validity : "",
+                                     (self->length + 7) / 8);
+}
+
+static PyObject *
+MrdbColumnBuffer_get_offsets(MrdbColumnBuffer *self, void *closure)
+{
+    if (self->item_size)
+        Py_RETURN_NONE;
+    if (!self->offsets)
+    {
+        int64_t zero= 0;
+        return PyBytes_FromStringAndSize((char *)&zero, sizeof(int64_t));
+    }
+    return PyBytes_FromStringAndSize((char *)self->offsets,
+                                     (self->length + 1) * sizeof(int64_t));
+}
+
+static PyObject *
+MrdbColumnBuffer_repr(MrdbColumnBuffer *self)
+{
+    return PyUnicode_FromFormat("<mariadb.ColumnBuffer %R %s, %zd values>",
+                                self->name,
+                                column_buffer_type_names[self->type],
+                                self->length);
+}
+
+static PyGetSetDef MrdbColumnBuffer_sets[]=
+{
+    {"type", (getter)MrdbColumnBuffer_get_type, NULL,
+        column_buffer_type__doc__, NULL},
+    {"validity", (getter)MrdbColumnBuffer_get_validity, NULL,
+        column_buffer_validity__doc__, NULL},
+    {"offsets", (getter)MrdbColumnBuffer_get_offsets, NULL,
+        column_buffer_offsets__doc__, NULL},
+    {NULL}
+};
+
+static PyMemberDef MrdbColumnBuffer_Members[] =
+{
+    {"name",
+        T_OBJECT,
+        offsetof(MrdbColumnBuffer, name),
+        READONLY,
+        column_buffer_name__doc__},
+    {"null_count",
+        T_PYSSIZET,
+        offsetof(MrdbColumnBuffer, null_count),
+        READONLY,
+        column_buffer_null_count__doc__},
+    {NULL}
+};
+
+static PySequenceMethods MrdbColumnBuffer_as_sequence=
+{
+    .sq_length= (lenfunc)MrdbColumnBuffer_length,
+};
+
+static PyBufferProcs MrdbColumnBuffer_as_buffer=
+{
+    .bf_getbuffer= (getbufferproc)MrdbColumnBuffer_getbuffer,
+};
+
+PyTypeObject MrdbColumnBuffer_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mariadb.ColumnBuffer",
+    .tp_basicsize= (Py_ssize_t)sizeof(MrdbColumnBuffer),
+    .tp_dealloc= (destructor)MrdbColumnBuffer_dealloc,
+    .tp_repr= (reprfunc)MrdbColumnBuffer_repr,
+    .tp_as_sequence= &MrdbColumnBuffer_as_sequence,
+    .tp_as_buffer= &MrdbColumnBuffer_as_buffer,
+    .tp_flags= Py_TPFLAGS_DEFAULT,
+    .tp_doc= column_buffer__doc__,
+    .tp_members= (struct PyMemberDef *)MrdbColumnBuffer_Members,
+    .tp_getset= MrdbColumnBuffer_sets,
+};
@@ -78,6 +78,9 @@ MrdbConnection_dump_debug_info(MrdbConnection *self);
 static PyObject *
 MrdbConnection_warnings(MrdbConnection *self);
 
+static PyObject *
+MrdbConnection_get_max_allowed_packet(MrdbConnection *self);
+
 static PyObject *
 MrdbConnection_executecommand(MrdbConnection *self,
                              PyObject *command);
@@ -167,6 +170,10 @@ MrdbConnection_Methods[] =
     {"_get_socket", (PyCFunction)MrdbConnection_socket,
       METH_NOARGS,
       "For internal use only"},
+    {"_get_max_allowed_packet",
+      (PyCFunction)MrdbConnection_get_max_allowed_packet,
+      METH_NOARGS,
+      "For internal use only"},
     {NULL} /* always last */
 };
 
@@ -188,11 +195,26 @@ PyMemberDef MrdbConnection_Members[] =
         offsetof(MrdbConnection, converter),
         0,
         "Conversion dictionary"},
+    {"_decimal_format",
+        T_UBYTE,
+        offsetof(MrdbConnection, decimal_format),
+        0,
+        "Representation of DECIMAL values"},
     {"_tls",
         T_BOOL,
         offsetof(MrdbConnection, tls_in_use),
         0,
         "Indicates if connection uses TLS/SSL"},
+    {"_ext_capabilities",
+        T_ULONG,
+        offsetof(MrdbConnection, ext_capabilities),
+        READONLY,
+        "Extended server capabilities"},
+    {"_max_allowed_packet",
+        T_ULONG,
+        offsetof(MrdbConnection, max_allowed_packet),
+        READONLY,
+        "Maximum packet size of client and server"},
     {NULL} /* always last */
 };
 
@@ -300,6 +322,23 @@ void MrdbConnection_process_status_info(void *data, enum enum_mariadb_status_inf
 } 
 #endif
 
+/* {{{ MrdbConnection_UpdateCapabilities
+   Caches the extended server capabilities, which are checked for each
+   parameter when executing statements, and invalidates the cached
+   max_allowed_packet. Must be called after the connection was
+   (re)established or the user was changed. */
+static void
+MrdbConnection_UpdateCapabilities(MrdbConnection *self)
+{
+    unsigned long caps= 0;
+
+    mariadb_get_infov(self->mysql,
+                      MARIADB_CONNECTION_EXTENDED_SERVER_CAPABILITIES, &caps);
+    self->ext_capabilities= caps;
+    self->max_allowed_packet= 0;
+}
+/* }}} */
+
 static int
 MrdbConnection_Initialize(MrdbConnection *self,
         PyObject *args,
@@ -486,6 +525,7 @@ MrdbConnection_Initialize(MrdbConnection *self,
         self->tls_in_use= 1;
 
     mariadb_get_infov(self->mysql, MARIADB_CONNECTION_HOST, (void *)&self->host);
+    MrdbConnection_UpdateCapabilities(self);
 
     has_error= 0;
 end:
@@ -567,11 +607,18 @@ void MrdbConnection_finalize(MrdbConnection *self)
     {
         if (self->mysql)
         {
+            if (self->prefetch)
+                MrdbPrefetch_Stop(self->prefetch);
             MARIADB_BEGIN_ALLOW_THREADS(self)
             mysql_close(self->mysql);
             MARIADB_END_ALLOW_THREADS(self)
             self->mysql= NULL;
         }
+        /* handles were invalidated by mysql_close: release memory */
+        MrdbConnection_ClosePendingStatements(self);
+        MARIADB_FREE_MEM(self->pending_stmts);
+        self->pending_stmt_size= 0;
+        Py_CLEAR(self->named_tuple_types);
     }
 }
 
@@ -609,6 +656,8 @@ PyObject *MrdbConnection_close(MrdbConnection *self)
     MARIADB_END_ALLOW_THREADS(self)
     self->mysql= NULL;
     self->closed= 1;
+    MrdbConnection_ClosePendingStatements(self);
+    Py_CLEAR(self->named_tuple_types);
     Py_RETURN_NONE;
 }
 
@@ -621,6 +670,54 @@ MrdbConnection_exception(PyObject *self, void *closure)
     return exception;
 }
 
+/* {{{ MrdbConnection_get_max_allowed_packet
+   Returns the maximum packet size accepted by client and server. The
+   server value can't be changed within a session, so it will be read
+   only once per session (see MrdbConnection_UpdateCapabilities). The
+   raw value is used, converters of the connection don't apply. */
+static PyObject *
+MrdbConnection_get_max_allowed_packet(MrdbConnection *self)
+{
+    MYSQL_RES *result= NULL;
+    MYSQL_ROW row;
+    unsigned long long server;
+    size_t client= 0;
+
+    MARIADB_CHECK_CONNECTION(self, NULL);
+
+    if (self->max_allowed_packet)
+        return PyLong_FromUnsignedLong(self->max_allowed_packet);
+
+    /* a background reader of a cursor uses the connection */
+    if (self->prefetch)
+        MrdbPrefetch_Stop(self->prefetch);
+
+    MARIADB_BEGIN_ALLOW_THREADS(self);
+    if (!mysql_query(self->mysql, "SELECT @@max_allowed_packet"))
+        result= mysql_store_result(self->mysql);
+    MARIADB_END_ALLOW_THREADS(self);
+
+    if (!result)
+    {
+        mariadb_throw_exception(self->mysql, NULL, 0, NULL);
+        return NULL;
+    }
+    if (!(row= mysql_fetch_row(result)) || !row[0])
+    {
+        mysql_free_result(result);
+        mariadb_throw_exception(NULL, Mariadb_InterfaceError, 0,
+                "Can't determine max_allowed_packet");
+        return NULL;
+    }
+    server= strtoull(row[0], NULL, 10);
+    mysql_free_result(result);
+
+    mariadb_get_infov(self->mysql, MARIADB_MAX_ALLOWED_PACKET, &client);
+    self->max_allowed_packet= (unsigned long)(server < client ? server : client);
+    return PyLong_FromUnsignedLong(self->max_allowed_packet);
+}
+/* }}} */
+
 /* {{{ MrdbConnection_ping */
 PyObject *MrdbConnection_ping(MrdbConnection *self)
 {
@@ -636,6 +733,8 @@ PyObject *MrdbConnection_ping(MrdbConnection *self)
         mariadb_throw_exception(self->mysql, Mariadb_InterfaceError, 0, NULL);
         return NULL;
     }
+    /* connection might have been reestablished (auto reconnect) */
+    MrdbConnection_UpdateCapabilities(self);
 
     Py_RETURN_NONE;
 }
@@ -663,6 +762,7 @@ PyObject *MrdbConnection_change_user(MrdbConnection *self,
         mariadb_throw_exception(self->mysql, NULL, 0, NULL);
         return NULL;
     }
+    MrdbConnection_UpdateCapabilities(self);
     Py_RETURN_NONE;
 }
 /* }}} */
@@ -875,7 +975,7 @@ PyObject *MrdbConnection_reconnect(MrdbConnection *self)
         mariadb_throw_exception(self->mysql, NULL, 0, NULL);
         return NULL;
     }
-    /* get capabilities */
+    MrdbConnection_UpdateCapabilities(self);
     Py_RETURN_NONE;
 }
 /* }}} */
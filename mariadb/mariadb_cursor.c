@@ -44,11 +44,26 @@ static PyObject *
 MrdbCursor_check_text_types(MrdbCursor *self);
 
 static PyObject *
-MrdbCursor_fetchrows(MrdbCursor *self, PyObject *rows);
+MrdbCursor_fetchrows(MrdbCursor *self, PyObject *args);
+
+static PyObject *
+MrdbCursor_fetchall(MrdbCursor *self);
+
+static PyObject *
+MrdbCursor_iter(MrdbCursor *self);
+
+static PyObject *
+MrdbCursor_iternext(MrdbCursor *self);
+
+static PyObject *
+MrdbCursor_fetch_columns(MrdbCursor *self, PyObject *rows);
 
 static PyObject *
 MrdbCursor_parse(MrdbCursor *self, PyObject *stmt);
 
+static PyObject *
+MrdbCursor_batch_parts(MrdbCursor *self);
+
 static PyObject *
 MrdbCursor_description(MrdbCursor *self);
 
@@ -60,10 +75,17 @@ MrdbCursor_seek(MrdbCursor *self,
                 PyObject *offset);
 
 static PyObject *
-MrdbCursor_execute_bulk(MrdbCursor *self);
+MrdbCursor_execute_bulk(MrdbCursor *self, PyObject *args);
+
+static PyObject *
+MrdbCursor_blob_length(MrdbCursor *self, PyObject *column);
+
+static PyObject *
+MrdbCursor_read_blob(MrdbCursor *self, PyObject *args);
 
 void
-field_fetch_fromtext(MrdbCursor *self, char *data, unsigned int column);
+field_fetch_fromtext(MrdbCursor *self, char *data, unsigned long length,
+                     unsigned int column);
 
 static PyObject *
 MrdbCursor_readresponse(MrdbCursor *self);
@@ -72,7 +94,9 @@ PyObject *MrdbCursor_clear_result(MrdbCursor *self);
 
 void
 field_fetch_callback(void *data, unsigned int column, unsigned char **row);
-static PyObject *mariadb_get_sequence_or_tuple(MrdbCursor *self);
+
+/* Builds a row object from the fetched values */
+typedef PyObject *(*MrdbRow_Build)(MrdbCursor *self);
 
 /* todo: write more documentation, this is just a placeholder */
 static char mariadb_cursor_documentation[] =
@@ -98,7 +122,13 @@ strncpy((a)->statement, (s), (l));\
     ((a)->parseinfo.is_text ? mysql_insert_id((a)->connection->mysql) : (a)->stmt ? mysql_stmt_insert_id((a)->stmt) : 0)
 
 #define CURSOR_NUM_ROWS(a)\
-    ((a)->parseinfo.is_text ? mysql_num_rows((a)->result) : (a)->stmt ? mysql_stmt_num_rows((a)->stmt) : 0)
+    ((a)->spool ? (a)->spool->row_count : (a)->parseinfo.is_text ? mysql_num_rows((a)->result) : (a)->stmt ? mysql_stmt_num_rows((a)->stmt) : 0)
+
+/* number of rows the iterator decodes in advance (buffered cursors) */
+#define MRDB_READ_AHEAD_ROWS 64
+
+/* initial number of rows per COM_STMT_FETCH for adaptive fetch size */
+#define MRDB_FETCH_ROWS_INITIAL 16
 
 static char *mariadb_named_tuple_name= "mariadb.Row";
 static char *mariadb_named_tuple_desc= "Named tupled row";
@@ -136,6 +166,15 @@ static PyMethodDef MrdbCursor_Methods[] =
         METH_NOARGS,
         cursor_fetchone__doc__,},
     {"fetchrows", (PyCFunction)MrdbCursor_fetchrows,
+        METH_VARARGS,
+        NULL},
+    {"fetchall", (PyCFunction)MrdbCursor_fetchall,
+        METH_NOARGS,
+        cursor_fetchall__doc__},
+    {"_fetch_columns", (PyCFunction)MrdbCursor_fetch_columns,
+        METH_O,
+        NULL},
+    {"_arrow_c_stream", (PyCFunction)MrdbCursor_arrow_c_stream,
         METH_O,
         NULL},
     {"_nextset", (PyCFunction)MrdbCursor_nextset,
@@ -151,12 +190,21 @@ static PyMethodDef MrdbCursor_Methods[] =
     {"_seek", (PyCFunction)MrdbCursor_seek,
         METH_O,
         NULL},
+    {"_blob_length", (PyCFunction)MrdbCursor_blob_length,
+        METH_O,
+        NULL},
+    {"_read_blob", (PyCFunction)MrdbCursor_read_blob,
+        METH_VARARGS,
+        NULL},
     {"_initresult", (PyCFunction)MrdbCursor_InitResultSet,
         METH_NOARGS,
         NULL},
     {"_parse", (PyCFunction)MrdbCursor_parse,
         METH_O,
         NULL},
+    {"_batch_parts", (PyCFunction)MrdbCursor_batch_parts,
+        METH_NOARGS,
+        NULL},
     {"_readresponse", (PyCFunction)MrdbCursor_readresponse,
         METH_NOARGS,
          NULL},
@@ -167,7 +215,7 @@ static PyMethodDef MrdbCursor_Methods[] =
         METH_NOARGS,
         NULL},
     {"_execute_bulk", (PyCFunction)MrdbCursor_execute_bulk,
-        METH_NOARGS,
+        METH_VARARGS,
         NULL},
     {"_initresult", (PyCFunction)MrdbCursor_InitResultSet,
         METH_NOARGS,
@@ -208,6 +256,11 @@ static struct PyMemberDef MrdbCursor_Members[] =
         offsetof(MrdbCursor, parseinfo.is_text),
         0,
         MISSING_DOC},
+    {"_returning",
+        T_BOOL,
+        offsetof(MrdbCursor, parseinfo.has_returning),
+        READONLY,
+        MISSING_DOC},
     {"_paramlist",
         T_OBJECT,
         offsetof(MrdbCursor, parseinfo.paramlist),
@@ -218,6 +271,31 @@ static struct PyMemberDef MrdbCursor_Members[] =
         offsetof(MrdbCursor, result_format),
         0,
         MISSING_DOC},
+    {"_decimal_format",
+        T_UBYTE,
+        offsetof(MrdbCursor, decimal_format),
+        0,
+        MISSING_DOC},
+    {"_intern_strings",
+        T_BOOL,
+        offsetof(MrdbCursor, intern_strings),
+        0,
+        MISSING_DOC},
+    {"_prefetch",
+        T_UINT,
+        offsetof(MrdbCursor, prefetch_capacity),
+        0,
+        MISSING_DOC},
+    {"_blob_as_memoryview",
+        T_BOOL,
+        offsetof(MrdbCursor, blob_as_memoryview),
+        0,
+        MISSING_DOC},
+    {"_stream_blobs",
+        T_BOOL,
+        offsetof(MrdbCursor, stream_blobs),
+        0,
+        MISSING_DOC},
     {"_keys",
         T_OBJECT,
         offsetof(MrdbCursor, parseinfo.keys),
@@ -238,6 +316,21 @@ static struct PyMemberDef MrdbCursor_Members[] =
         offsetof(MrdbCursor, cursor_type),
         0,
         MISSING_DOC},
+    {"_fetch_buffer_size",
+        T_ULONG,
+        offsetof(MrdbCursor, fetch_buffer_size),
+        0,
+        MISSING_DOC},
+    {"_buffer_limit",
+        T_ULONGLONG,
+        offsetof(MrdbCursor, buffer_limit),
+        0,
+        MISSING_DOC},
+    {"_row_serial",
+        T_ULONGLONG,
+        offsetof(MrdbCursor, row_serial),
+        READONLY,
+        MISSING_DOC},
     {"buffered",
         T_BOOL,
         offsetof(MrdbCursor, is_buffered),
@@ -361,6 +454,8 @@ PyTypeObject MrdbCursor_Type =
     .tp_methods= (struct PyMethodDef *)MrdbCursor_Methods,
     .tp_members= (struct PyMemberDef *)MrdbCursor_Members,
     .tp_getset= MrdbCursor_sets,
+    .tp_iter= (getiterfunc)MrdbCursor_iter,
+    .tp_iternext= (iternextfunc)MrdbCursor_iternext,
     .tp_init= (initproc)MrdbCursor_initialize,
     .tp_new= PyType_GenericNew,
     .tp_finalize= (destructor)MrdbCursor_finalize
@@ -376,11 +471,29 @@ void MrdbCursor_clearparseinfo(MrdbParseInfo *parseinfo)
   memset(parseinfo, 0, sizeof(MrdbParseInfo));
 }
 
+/* {{{ MrdbCursor_ResetRow
+   The raw data of the current row is no longer accessible, blob
+   readers of this row become invalid */
+static void MrdbCursor_ResetRow(MrdbCursor *self)
+{
+    self->row_serial++;
+    self->has_row= 0;
+}
+/* }}} */
+
 /* {{{ MrdbCursor_clear_result(MrdbCursor *self)
    clear pending result sets
 */
 PyObject *MrdbCursor_clear_result(MrdbCursor *self)
 {
+    Py_CLEAR(self->read_ahead);
+    MrdbCursor_ResetRow(self);
+    MrdbPrefetch_Free(self);
+    MrdbSpool_Free(self);
+    MrdbCursor_DetachResult(self);
+    /* a background reader of another cursor uses the connection */
+    if (self->connection->prefetch)
+        MrdbPrefetch_Stop(self->connection->prefetch);
     if (!self->parseinfo.is_text &&
         self->stmt)
     {
@@ -459,16 +572,16 @@ void MrdbCursor_clear(MrdbCursor *self, uint8_t new_stmt)
     }
     self->fetched= 0;
 
-    if (self->sequence_fields)
-    {
-        MARIADB_FREE_MEM(self->sequence_fields);
-    }
+    Py_CLEAR(self->sequence_type);
     self->fields= NULL;
     self->row_count= 0;
     self->affected_rows= 0;
     MrdbCursor_FreeValues(self);
+    mariadb_free_bulk_parameters(self);
     MrdbCursor_clearparseinfo(&self->parseinfo);
     MARIADB_FREE_MEM(self->values);
+    MARIADB_FREE_MEM(self->raw_values);
+    mariadb_free_column_plan(self);
     MARIADB_FREE_MEM(self->bind);
     MARIADB_FREE_MEM(self->statement);
     MARIADB_FREE_MEM(self->value);
@@ -476,22 +589,6 @@ void MrdbCursor_clear(MrdbCursor *self, uint8_t new_stmt)
 }
 /* }}} */
 
-static void ma_set_result_column_value(MrdbCursor *self, PyObject *row, uint32_t column)
-{
-    switch (self->result_format) {
-        case RESULT_NAMED_TUPLE:
-            PyStructSequence_SET_ITEM(row, column, self->values[column]);
-            break;
-        case RESULT_DICTIONARY:
-            PyDict_SetItemString(row, self->fields[column].name, self->values[column]); 
-            Py_DECREF(self->values[column]); /* CONPY-119 */
-            break;
-        default:
-            PyTuple_SET_ITEM(row, column, (self)->values[column]);
-    }
-}
-
-
 /* {{{ ma_cursor_close 
    closes the statement handle of current cursor. After call to
    cursor_close the cursor can't be reused anymore
@@ -502,6 +599,8 @@ void ma_cursor_close(MrdbCursor *self)
     if (!self->closed)
     {
         MrdbCursor_clear_result(self);
+        if (self->connection)
+            MrdbConnection_ClosePendingStatements(self->connection);
         if (!self->parseinfo.is_text && self->stmt)
         {
             /* Todo: check if all the cursor stuff is deleted (when using prepared
@@ -531,6 +630,121 @@ static void MrdbCursor_finalize(MrdbCursor *self)
 {
     if (self->connection && self->connection->mysql)
         ma_cursor_close(self);
+    Py_CLEAR(self->read_ahead);
+    MrdbPrefetch_Free(self);
+    MrdbSpool_Free(self);
+    MrdbCursor_DetachResult(self);
+}
+/* }}} */
+
+/* {{{ Mrdb_GetNamedTupleType
+   Returns a new reference to the named tuple type for the current
+   result set.
+   Types are cached per connection with the ordered list of column names
+   as key, so executing the same statement again doesn't need to create
+   a new type. */
+static PyTypeObject *Mrdb_GetNamedTupleType(MrdbCursor *self)
+{
+    MrdbConnection *conn= self->connection;
+    PyStructSequence_Desc sequence_desc;
+    PyStructSequence_Field *sequence_fields= NULL;
+    PyTypeObject *type= NULL;
+    PyObject *names= NULL, *entry, *key;
+    Py_ssize_t i, size;
+    uint32_t j;
+    int rc;
+
+    if (!conn->named_tuple_types &&
+        !(conn->named_tuple_types= PyList_New(0)))
+        return NULL;
+
+    size= PyList_GET_SIZE(conn->named_tuple_types);
+    for (i= size - 1; i >= 0; i--)
+    {
+        entry= PyList_GET_ITEM(conn->named_tuple_types, i);
+        names= PyTuple_GET_ITEM(entry, 0);
+
+        if (PyTuple_GET_SIZE(names) != self->field_count)
+            continue;
+        for (j=0; j < self->field_count; j++)
+        {
+            const char *name= PyUnicode_AsUTF8(PyTuple_GET_ITEM(names, j));
+            if (!name || strcmp(name, self->fields[j].name))
+                break;
+        }
+        if (j < self->field_count)
+            continue;
+
+        type= (PyTypeObject *)PyTuple_GET_ITEM(entry, 1);
+        Py_INCREF(type);
+        /* move entry to the end, the oldest entries will be removed first */
+        if (i < size - 1)
+        {
+            Py_INCREF(entry);
+            if (PyList_SetSlice(conn->named_tuple_types, i, i + 1, NULL) ||
+                PyList_Append(conn->named_tuple_types, entry))
+                PyErr_Clear();
+            Py_DECREF(entry);
+        }
+        return type;
+    }
+
+    if (!(names= PyTuple_New(self->field_count)))
+        return NULL;
+    if (!(sequence_fields= (PyStructSequence_Field *)
+                PyMem_RawCalloc(self->field_count + 1,
+                    sizeof(PyStructSequence_Field))))
+    {
+        PyErr_NoMemory();
+        goto error;
+    }
+    for (j=0; j < self->field_count; j++)
+    {
+        PyObject *name= PyUnicode_FromString(self->fields[j].name);
+
+        if (!name)
+            goto error;
+        PyTuple_SET_ITEM(names, j, name);
+        sequence_fields[j].name= PyUnicode_AsUTF8(name);
+    }
+    sequence_desc.name= mariadb_named_tuple_name;
+    sequence_desc.doc= mariadb_named_tuple_desc;
+    sequence_desc.fields= sequence_fields;
+    sequence_desc.n_in_sequence= self->field_count;
+
+    if (!(type= PyStructSequence_NewType(&sequence_desc)))
+        goto error;
+
+    /* The type doesn't copy the field names, so the names need to
+       live as long as the type. Column names can't contain a NUL
+       character, so the key can't hide the member of a column */
+    if (!(key= PyUnicode_FromStringAndSize("\0names", 6)))
+        goto error;
+    rc= PyDict_SetItem(type->tp_dict, key, names);
+    Py_DECREF(key);
+    if (rc)
+        goto error;
+    PyType_Modified(type);
+
+    if (size >= MAX_NAMED_TUPLE_TYPES &&
+        PyList_SetSlice(conn->named_tuple_types, 0, 1, NULL))
+        goto error;
+    if (!(entry= PyTuple_Pack(2, names, (PyObject *)type)))
+        goto error;
+    if (PyList_Append(conn->named_tuple_types, entry))
+    {
+        Py_DECREF(entry);
+        goto error;
+    }
+    Py_DECREF(entry);
+    Py_DECREF(names);
+    MARIADB_FREE_MEM(sequence_fields);
+    return type;
+error:
+    Py_XDECREF(type);
+    Py_XDECREF(names);
+    MARIADB_FREE_MEM(sequence_fields);
+    return NULL;
 }
 /* }}} */
 
@@ -542,7 +756,9 @@ static int Mrdb_GetFieldInfo(MrdbCursor *self)
     {
         if (self->parseinfo.is_text)
         {
-            self->result= (self->is_buffered) ? mysql_store_result(self->connection->mysql) :
+            /* results with a memory limit will be read by MrdbSpool_Load */
+            self->result= (self->is_buffered && !self->buffer_limit) ?
+                mysql_store_result(self->connection->mysql) :
                 mysql_use_result(self->connection->mysql);
             if (!self->result)
             {
@@ -550,7 +766,7 @@ static int Mrdb_GetFieldInfo(MrdbCursor *self)
                 return 1;
             }
         }
-        else if (self->is_buffered)
+        else if (self->is_buffered && !self->buffer_limit)
         {
             if (mysql_stmt_store_result(self->stmt))
             {
@@ -564,37 +780,23 @@ static int Mrdb_GetFieldInfo(MrdbCursor *self)
         self->fields= (self->parseinfo.is_text) ? mysql_fetch_fields(self->result) :
             mariadb_stmt_fetch_fields(self->stmt);
 
-        if (self->result_format == RESULT_NAMED_TUPLE) {
-            unsigned int i;
-            PyStructSequence_Desc sequence_desc;
-
-            if (!(self->sequence_fields= (PyStructSequence_Field *)
-                        PyMem_RawCalloc(self->field_count + 1,
-                            sizeof(PyStructSequence_Field))))
-                return 1;
-            sequence_desc.name= mariadb_named_tuple_name;
-            sequence_desc.doc= mariadb_named_tuple_desc;
-            sequence_desc.fields= self->sequence_fields;
-            sequence_desc.n_in_sequence= self->field_count;
-
-
-            for (i=0; i < self->field_count; i++)
-            {
-                self->sequence_fields[i].name= self->fields[i].name;
-            }
-            self->sequence_type= PyStructSequence_NewType(&sequence_desc);
-#if PY_VERSION_HEX < 0x03070000
-            self->sequence_type->tp_flags|= Py_TPFLAGS_HEAPTYPE;
-#endif
-        }
+        if (self->result_format == RESULT_NAMED_TUPLE &&
+            !(self->sequence_type= Mrdb_GetNamedTupleType(self)))
+            return 1;
     }
     return 0;
 }
 
 PyObject *MrdbCursor_InitResultSet(MrdbCursor *self)
 {
-    MARIADB_FREE_MEM(self->sequence_fields);
+    Py_CLEAR(self->read_ahead);
+    MrdbCursor_ResetRow(self);
+    MrdbPrefetch_Free(self);
+    MrdbSpool_Free(self);
+    MrdbCursor_DetachResult(self);
+    Py_CLEAR(self->sequence_type);
     MARIADB_FREE_MEM(self->values);
+    MARIADB_FREE_MEM(self->raw_values);
 
     if (self->result)
     {
@@ -611,11 +813,27 @@ PyObject *MrdbCursor_InitResultSet(MrdbCursor *self)
 
         if (!(self->values= (PyObject**)PyMem_RawCalloc(self->field_count, sizeof(PyObject *))))
             return NULL;
+        self->fetch_raw= (self->result_format == RESULT_LAZY);
+        if (self->fetch_raw &&
+            !(self->raw_values= (MrdbRawValue *)PyMem_RawCalloc(self->field_count,
+                                                 sizeof(MrdbRawValue))))
+            return PyErr_NoMemory();
+        if (mariadb_init_column_plan(self))
+            return NULL;
         if (!self->parseinfo.is_text)
             mysql_stmt_attr_set(self->stmt, STMT_ATTR_CB_RESULT, field_fetch_callback);
+        self->measure_bytes= (self->fetch_buffer_size &&
+                              self->cursor_type == CURSOR_TYPE_READ_ONLY);
+
+        if (self->is_buffered && self->buffer_limit && MrdbSpool_Load(self))
+            return NULL;
 
         self->row_count= CURSOR_NUM_ROWS(self);
         self->affected_rows= 0;
+
+        if (!self->is_buffered && self->prefetch_capacity &&
+            MrdbPrefetch_Start(self))
+            return NULL;
     } else {
       self->row_count= self->affected_rows= CURSOR_AFFECTED_ROWS(self);
     }
@@ -630,14 +848,12 @@ static int Mrdb_execute_direct(MrdbCursor *self,
 {
    int rc;
 
-   MARIADB_BEGIN_ALLOW_THREADS(self->connection);
-   long ext_caps;
-
-   mariadb_get_infov(self->connection->mysql,
-                      MARIADB_CONNECTION_EXTENDED_SERVER_CAPABILITIES, &ext_caps);
-   
-   /* clear pending result sets */
+   /* clear pending result sets: this might release Python objects,
+      so the GIL needs to be held */
    MrdbCursor_clear_result(self);
+   MrdbConnection_ClosePendingStatements(self->connection);
+
+   MARIADB_BEGIN_ALLOW_THREADS(self->connection);
 
    /* if stmt is already prepared */
    if (!self->reprepare)
@@ -649,8 +865,7 @@ static int Mrdb_execute_direct(MrdbCursor *self,
    /* execute_direct was implemented together with bulk operations, so we need
       to check if MARIADB_CLIENT_STMT_BULK_OPERATIONS is set in extended server
       capabilities */
-   if (!(ext_caps &
-        (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32)))
+   if (!MRDB_BULK_SUPPORTED(self->connection))
    {
        if (!(rc= mysql_stmt_prepare(self->stmt, statement, (unsigned long)statement_len)))
        {
@@ -664,6 +879,17 @@ end:
    return rc;
 }
 
+/* {{{ MrdbCursor_UpdateMaxLength
+   max_length of string and blob columns is calculated by the column
+   decoders while fetching rows */
+static void MrdbCursor_UpdateMaxLength(MrdbCursor *self, uint32_t column)
+{
+    if (self->plan &&
+        self->plan->columns[column].max_length > self->fields[column].max_length)
+        self->fields[column].max_length= self->plan->columns[column].max_length;
+}
+/* }}} */
+
 /* {{{ MrdbCursor_metadata */
 static PyObject *MrdbCursor_metadata(MrdbCursor *self)
 {
@@ -696,6 +922,7 @@ static PyObject *MrdbCursor_metadata(MrdbCursor *self)
       PyTuple_SetItem(tuple[5], i, PyUnicode_FromString(self->fields[i].org_table));
       PyTuple_SetItem(tuple[6], i, PyLong_FromLong((long)self->fields[i].type));
       PyTuple_SetItem(tuple[7], i, PyLong_FromLong((long)self->fields[i].charsetnr));
+      MrdbCursor_UpdateMaxLength(self, i);
       PyTuple_SetItem(tuple[8], i, PyLong_FromLongLong((long long)self->fields[i].max_length));
       PyTuple_SetItem(tuple[9], i, PyLong_FromLongLong((long long)self->fields[i].length));
       PyTuple_SetItem(tuple[10], i, PyLong_FromLong((long)self->fields[i].decimals));
@@ -760,6 +987,7 @@ PyObject *MrdbCursor_description(MrdbCursor *self)
             PyObject *desc;
             Mrdb_ExtFieldType *ext_field_type= mariadb_extended_field_type(&self->fields[i]);
 
+            MrdbCursor_UpdateMaxLength(self, i);
             display_length= self->fields[i].max_length > self->fields[i].length ? 
                             self->fields[i].max_length : self->fields[i].length;
             mysql_get_character_set_info(self->connection->mysql, &cs);
@@ -812,20 +1040,179 @@ PyObject *MrdbCursor_description(MrdbCursor *self)
 }
 /* }}} */
 
+/* {{{ MrdbCursor_DiscardValues
+   Releases the column values of a row which couldn't be decoded
+   completely. Columns which were not decoded are NULL. */
+static void MrdbCursor_DiscardValues(MrdbCursor *self)
+{
+    unsigned int i;
+
+    for (i= 0; i < self->field_count; i++)
+    {
+        Py_CLEAR(self->values[i]);
+    }
+}
+/* }}} */
+
+/* {{{ row builders
+   Row builders take ownership of the values in self->values. The
+   builder for the result format of the cursor is resolved once per
+   fetch call */
+static PyObject *mariadb_build_tuple(MrdbCursor *self)
+{
+    PyObject *row;
+    uint32_t i;
+
+    if (!(row= PyTuple_New(self->field_count)))
+    {
+        MrdbCursor_DiscardValues(self);
+        return NULL;
+    }
+    for (i= 0; i < self->field_count; i++)
+        PyTuple_SET_ITEM(row, i, self->values[i]);
+    return row;
+}
+
+static PyObject *mariadb_build_named_tuple(MrdbCursor *self)
+{
+    PyObject *row;
+    uint32_t i;
+
+    if (!(row= PyStructSequence_New(self->sequence_type)))
+    {
+        MrdbCursor_DiscardValues(self);
+        return NULL;
+    }
+    for (i= 0; i < self->field_count; i++)
+        PyStructSequence_SET_ITEM(row, i, self->values[i]);
+    return row;
+}
+
+static PyObject *mariadb_build_dictionary(MrdbCursor *self)
+{
+    PyObject *row;
+    uint32_t i;
+
+    if (!(row= PyDict_Copy(self->row_template)))
+    {
+        MrdbCursor_DiscardValues(self);
+        return NULL;
+    }
+    for (i= 0; i < self->field_count; i++)
+    {
+        int rc= PyDict_SetItem(row, self->plan->columns[i].name,
+                               self->values[i]);
+        Py_CLEAR(self->values[i]); /* CONPY-119 */
+        if (rc)
+        {
+            MrdbCursor_DiscardValues(self);
+            Py_DECREF(row);
+            return NULL;
+        }
+    }
+    return row;
+}
+
+static PyObject *mariadb_build_lazy_row(MrdbCursor *self)
+{
+    return MrdbRow_New(self->plan, self->raw_values);
+}
+
+static MrdbRow_Build mariadb_row_builder(MrdbCursor *self)
+{
+    switch (self->result_format)
+    {
+        case RESULT_NAMED_TUPLE:
+            return mariadb_build_named_tuple;
+        case RESULT_DICTIONARY:
+            return mariadb_build_dictionary;
+        case RESULT_LAZY:
+            return mariadb_build_lazy_row;
+        default:
+            return mariadb_build_tuple;
+    }
+}
+/* }}} */
+
+/* {{{ MrdbCursor_AdaptFetchSize
+   Adaptive fetch size for server side cursors: If all rows of the last
+   COM_STMT_FETCH were consumed, the number of rows for the next
+   COM_STMT_FETCH will be doubled, as long as the estimated size of a
+   batch doesn't exceed fetch_buffer_size. */
+static void MrdbCursor_AdaptFetchSize(MrdbCursor *self)
+{
+    uint64_t rows, row_size, limit;
+
+    /* a fetch_rows value of 0 means default (1 row) */
+    if (self->cursor_type != CURSOR_TYPE_READ_ONLY || self->is_buffered ||
+        !self->batch_rows || self->batch_rows < self->fetch_rows)
+        return;
+
+    if (!(row_size= self->batch_bytes / self->batch_rows))
+        row_size= 1;
+    if (!(limit= self->fetch_buffer_size / row_size))
+        limit= 1;
+    rows= self->fetch_rows ? (uint64_t)self->fetch_rows * 2 : 2;
+    if (rows > limit)
+        rows= limit;
+    if (rows > ULONG_MAX)
+        rows= ULONG_MAX;
+
+    if (rows != self->fetch_rows)
+    {
+        self->fetch_rows= (unsigned long)rows;
+        mysql_stmt_attr_set(self->stmt, STMT_ATTR_PREFETCH_ROWS,
+                            &self->fetch_rows);
+    }
+    self->batch_rows= self->batch_bytes= 0;
+}
+/* }}} */
+
+/* {{{ MrdbCursor_fetchinternal
+   Fetches the next row into self->values.
+
+   Returns 0 on success, 1 if no more rows are available, or -1 if
+   a column value couldn't be decoded (exception is set) */
 static int MrdbCursor_fetchinternal(MrdbCursor *self)
 {
     unsigned int field_count= self->field_count;
     MYSQL_ROW row;
+    unsigned long *lengths;
     int rc;
     unsigned int i;
 
     self->fetched= 1;
+    self->row_bytes= 0;
+    MrdbCursor_ResetRow(self);
+
+    if (self->spool)
+    {
+        rc= MrdbSpool_Fetch(self);
+        self->has_row= !rc;
+        return rc;
+    }
+
+    if (self->prefetch && MrdbPrefetch_Fetch(self, &rc))
+    {
+        self->has_row= !rc;
+        return rc;
+    }
 
     if (!self->parseinfo.is_text)
     {
+        if (self->fetch_buffer_size)
+            MrdbCursor_AdaptFetchSize(self);
         rc= mysql_stmt_fetch(self->stmt);
         if (rc == MYSQL_NO_DATA)
             return 1;
+        self->has_row= 1;
+        self->batch_rows++;
+        self->batch_bytes+= self->row_bytes;
+        if (PyErr_Occurred())
+        {
+            MrdbCursor_DiscardValues(self);
+            return -1;
+        }
         return 0;
     }
 
@@ -833,21 +1220,86 @@ static int MrdbCursor_fetchinternal(MrdbCursor *self)
     {
         return 1;
     }
+    lengths= mysql_fetch_lengths(self->result);
+    self->current_row= row;
+    self->current_lengths= lengths;
+    self->has_row= 1;
+
+    if (self->measure_bytes)
+    {
+        for (i= 0; i < field_count; i++)
+            self->row_bytes+= lengths[i];
+    }
+
+    /* lazy rows and columnar fetch: raw values will be copied */
+    if (self->fetch_raw)
+    {
+        for (i= 0; i < field_count; i++)
+        {
+            self->raw_values[i].data= (unsigned char *)row[i];
+            self->raw_values[i].length= lengths[i];
+        }
+        return 0;
+    }
 
     for (i= 0; i < field_count; i++)
     {
-        field_fetch_fromtext(self, row[i], i);
+        field_fetch_fromtext(self, row[i], lengths[i], i);
+        if (!self->values[i])
+        {
+            for (i++; i < field_count; i++)
+                self->values[i]= NULL;
+            MrdbCursor_DiscardValues(self);
+            return -1;
+        }
     }
     return 0;
 }
+/* }}} */
+
+/* {{{ MrdbCursor_SeekRow */
+static void MrdbCursor_SeekRow(MrdbCursor *self, uint64_t position)
+{
+    if (self->spool)
+    {
+        self->spool->position= position;
+        return;
+    }
+    MARIADB_BEGIN_ALLOW_THREADS(self->connection);
+    if (self->parseinfo.is_text)
+        mysql_data_seek(self->result, position);
+    else
+        mysql_stmt_data_seek(self->stmt, position);
+    MARIADB_END_ALLOW_THREADS(self->connection);
+}
+/* }}} */
+
+/* {{{ MrdbCursor_DropReadAhead
+   Discards rows which were decoded in advance by the iterator, but not
+   returned yet. Since read-ahead is only used for buffered result sets,
+   the result set will be positioned back to the row following the last
+   returned row. */
+static void MrdbCursor_DropReadAhead(MrdbCursor *self)
+{
+    if (!self->read_ahead)
+        return;
+    if (self->read_ahead_pos < PyList_GET_SIZE(self->read_ahead))
+    {
+        MrdbCursor_SeekRow(self, self->row_number);
+        MrdbCursor_ResetRow(self);
+    }
+    Py_CLEAR(self->read_ahead);
+}
+/* }}} */
 
 static PyObject *
 MrdbCursor_fetchone(MrdbCursor *self)
 {
-    PyObject *row;
-    uint32_t i;
+    int rc;
     unsigned int field_count= self->field_count;
 
+    MrdbCursor_DropReadAhead(self);
+
     if (self->cursor_type == CURSOR_TYPE_READ_ONLY)
       MARIADB_CHECK_STMT(self);
     if (PyErr_Occurred())
@@ -861,22 +1313,15 @@ MrdbCursor_fetchone(MrdbCursor *self)
                 "Cursor doesn't have a result set");
         return NULL;
     }
-    if (MrdbCursor_fetchinternal(self))
+    if ((rc= MrdbCursor_fetchinternal(self)))
     {
+        if (rc < 0)
+            return NULL;
         Py_RETURN_NONE;
     }
 
     self->row_number++;
-    if (!(row= mariadb_get_sequence_or_tuple(self)))
-    {
-        return NULL;
-    }
-
-    for (i= 0; i < field_count; i++)
-    {
-        ma_set_result_column_value(self, row, i);
-    }
-    return row;
+    return mariadb_row_builder(self)(self);
 }
 
 static PyObject *MrdbCursor_seek(MrdbCursor *self, PyObject *pos)
@@ -890,29 +1335,171 @@ static PyObject *MrdbCursor_seek(MrdbCursor *self, PyObject *pos)
 
     new_position= (uint64_t)PyLong_AsUnsignedLongLong(pos);
 
-    MARIADB_BEGIN_ALLOW_THREADS(self->connection);
-    if (self->parseinfo.is_text)
-        mysql_data_seek(self->result, new_position);
-    else
-        mysql_stmt_data_seek(self->stmt, new_position);
-    MARIADB_END_ALLOW_THREADS(self->connection);
+    Py_CLEAR(self->read_ahead);
+    MrdbCursor_SeekRow(self, new_position);
+    MrdbCursor_ResetRow(self);
 
     Py_RETURN_NONE;
 }
 
-static PyObject *
-mariadb_get_sequence_or_tuple(MrdbCursor *self)
+/* {{{ MrdbCursor_GetBlobValue
+   Retrieves the raw data of a BLOB or TEXT column of the current row,
+   the column can be specified by index or name. For NULL values data
+   will be NULL.
+   Returns 0 on success, 1 if an error occurred (exception is set) */
+static uint8_t
+MrdbCursor_GetBlobValue(MrdbCursor *self, PyObject *column,
+                        MrdbRawValue *value)
 {
-    switch (self->result_format)
+    Py_ssize_t index= -1;
+    uint32_t i;
+    MrdbColumn *col;
+
+    if (!self->field_count || !self->plan)
     {
-        case RESULT_NAMED_TUPLE:
-            return PyStructSequence_New(self->sequence_type);
-        case RESULT_DICTIONARY:
-            return PyDict_New();
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Cursor doesn't have a result set");
+        return 1;
+    }
+
+    if (PyLong_Check(column))
+    {
+        if ((index= PyLong_AsSsize_t(column)) == -1 && PyErr_Occurred())
+            return 1;
+    } else if (PyUnicode_Check(column))
+    {
+        const char *name;
+
+        if (!(name= PyUnicode_AsUTF8(column)))
+            return 1;
+        for (i= 0; i < self->field_count; i++)
+        {
+            if (!strcmp(self->fields[i].name, name))
+            {
+                index= i;
+                break;
+            }
+        }
+    } else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Column must be specified by index or name");
+        return 1;
+    }
+
+    if (index < 0 || index >= (Py_ssize_t)self->field_count)
+    {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Invalid column specified");
+        return 1;
+    }
+
+    col= &self->plan->columns[index];
+    switch (col->type) {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_VARCHAR:
+        case MYSQL_TYPE_JSON:
+        case MYSQL_TYPE_GEOMETRY:
+            break;
         default:
-            return PyTuple_New(self->field_count);
+            mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                    "Column '%s' is not a BLOB or TEXT column",
+                    self->fields[index].name);
+            return 1;
+    }
+
+    /* the iterator of buffered cursors decodes rows in advance, so
+       the raw data belongs to a row which wasn't returned yet */
+    if (!self->has_row ||
+        (self->read_ahead &&
+         self->read_ahead_pos < PyList_GET_SIZE(self->read_ahead)))
+    {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "No current row available");
+        return 1;
+    }
+
+    if (self->spool)
+        *value= self->spool->raw[index];
+    else if (self->prefetch && self->prefetch->held)
+    {
+        /* the held slot isn't accessed by the background reader */
+        *value= self->prefetch->slots[self->prefetch->head].raw[index];
+    }
+    else if (self->parseinfo.is_text)
+    {
+        value->data= (unsigned char *)self->current_row[index];
+        value->length= self->current_lengths[index];
+        return 0;
+    }
+    else
+        value->data= col->current;
+
+    /* binary protocol values contain a length prefix */
+    if (!self->parseinfo.is_text && value->data)
+    {
+        unsigned char *p= value->data;
+
+        value->length= mysql_net_field_length(&p);
+        value->data= p;
     }
+    return 0;
 }
+/* }}} */
+
+/* {{{ MrdbCursor_blob_length
+   Returns the length of a BLOB or TEXT value of the current row, or
+   None for NULL values */
+static PyObject *
+MrdbCursor_blob_length(MrdbCursor *self, PyObject *column)
+{
+    MrdbRawValue value;
+
+    if (MrdbCursor_GetBlobValue(self, column, &value))
+        return NULL;
+    if (!value.data)
+        Py_RETURN_NONE;
+    return PyLong_FromUnsignedLong(value.length);
+}
+/* }}} */
+
+/* {{{ MrdbCursor_read_blob
+   Copies data of a BLOB or TEXT value of the current row, starting at
+   the given offset, into a writable buffer. Returns the number of bytes
+   copied, 0 if the offset reached the end of the value. */
+static PyObject *
+MrdbCursor_read_blob(MrdbCursor *self, PyObject *args)
+{
+    PyObject *column;
+    unsigned long long offset;
+    Py_buffer buffer;
+    MrdbRawValue value;
+    size_t length= 0;
+
+    if (!PyArg_ParseTuple(args, "OKw*", &column, &offset, &buffer))
+        return NULL;
+
+    if (MrdbCursor_GetBlobValue(self, column, &value))
+    {
+        PyBuffer_Release(&buffer);
+        return NULL;
+    }
+
+    if (value.data && offset < value.length)
+    {
+        length= (size_t)(value.length - offset);
+        if (length > (size_t)buffer.len)
+            length= (size_t)buffer.len;
+        memcpy(buffer.buf, value.data + offset, length);
+    }
+    PyBuffer_Release(&buffer);
+    return PyLong_FromSize_t(length);
+}
+/* }}} */
 
 static PyObject *
 MrdbCursor_nextset(MrdbCursor *self)
@@ -925,6 +1512,11 @@ MrdbCursor_nextset(MrdbCursor *self)
         return NULL;
     }
 
+    Py_CLEAR(self->read_ahead);
+    MrdbPrefetch_Free(self);
+    MrdbSpool_Free(self);
+    MrdbCursor_DetachResult(self);
+
     if (!self->parseinfo.is_text)
     {
         if (!self->stmt)
@@ -968,7 +1560,12 @@ Mariadb_row_count(MrdbCursor *self)
     if (!self->parseinfo.statement)
         return PyLong_FromLongLong(-1);
     if (self->field_count)
+    {
+        /* rows read by a background reader weren't fetched yet */
+        if (self->prefetch)
+            return PyLong_FromLongLong(self->row_number);
         return PyLong_FromLongLong(CURSOR_NUM_ROWS(self));
+    }
     return PyLong_FromLongLong(CURSOR_AFFECTED_ROWS(self));
 }
 
@@ -1047,6 +1644,7 @@ MrdbCursor_parse(MrdbCursor *self, PyObject *stmt)
     parser->param_list= NULL;
     self->parseinfo.is_text= (parser->command == SQL_NONE || parser->command == SQL_OTHER);
     self->parseinfo.command= parser->command;
+    self->parseinfo.has_returning= parser->has_returning;
 
     if (parser->paramstyle == PYFORMAT && parser->keys)
     {
@@ -1064,6 +1662,51 @@ MrdbCursor_parse(MrdbCursor *self, PyObject *stmt)
     Py_RETURN_NONE;
 }
 
+/* {{{ MrdbCursor_batch_parts
+   Splits the parsed INSERT or REPLACE statement into prefix, row
+   constructor and suffix, which will be used by executemany() to build
+   multi-row statements if the server doesn't support bulk operations.
+   Returns None if the statement can't be rewritten. */
+static PyObject *
+MrdbCursor_batch_parts(MrdbCursor *self)
+{
+    MrdbParser *parser;
+    PyObject *parts= NULL;
+    const char *statement= self->parseinfo.statement;
+    size_t statement_len= self->parseinfo.statement_len;
+    size_t ofs, len;
+    char errmsg[128];
+
+    if (!statement || (self->parseinfo.command != SQL_INSERT &&
+                       self->parseinfo.command != SQL_REPLACE))
+        Py_RETURN_NONE;
+
+    if (!(parser= MrdbParser_init(self->connection->mysql, statement,
+                                  statement_len)))
+    {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Can't initialize parser.");
+        return NULL;
+    }
+
+    if (!MrdbParser_parse(parser, 1, errmsg, 128) &&
+        !MrdbParser_get_row(parser, &ofs, &len))
+    {
+        parts= Py_BuildValue("(s#s#s#)",
+                             statement, (Py_ssize_t)ofs,
+                             statement + ofs, (Py_ssize_t)len,
+                             statement + ofs + len,
+                             (Py_ssize_t)(statement_len - ofs - len));
+    }
+    Py_XDECREF(parser->param_list);
+    MrdbParser_end(parser);
+
+    if (!parts && !PyErr_Occurred())
+        Py_RETURN_NONE;
+    return parts;
+}
+/* }}} */
+
 static PyObject *
 MrdbCursor_execute_binary(MrdbCursor *self)
 {
@@ -1073,11 +1716,15 @@ MrdbCursor_execute_binary(MrdbCursor *self)
 
     MARIADB_CHECK_CONNECTION(self->connection, NULL);
 
-    if (!self->stmt &&
-        !(self->stmt= mysql_stmt_init(self->connection->mysql)))
+    if (!self->stmt)
     {
-        mariadb_throw_exception(self->connection->mysql, NULL, 0, NULL);
-        goto error;
+        if (!(self->stmt= mysql_stmt_init(self->connection->mysql)))
+        {
+            mariadb_throw_exception(self->connection->mysql, NULL, 0, NULL);
+            goto error;
+        }
+        /* statement handle was handed over to a result holder */
+        self->reprepare= 1;
     }
 
     /* CONPY-164: reset array_size */
@@ -1094,6 +1741,15 @@ MrdbCursor_execute_binary(MrdbCursor *self)
             goto error;
     }
 
+    if (self->cursor_type == CURSOR_TYPE_READ_ONLY)
+    {
+        self->fetch_rows= self->prefetch_rows;
+        if (!self->fetch_rows && self->fetch_buffer_size)
+            self->fetch_rows= MRDB_FETCH_ROWS_INITIAL;
+        self->batch_rows= self->batch_bytes= 0;
+        mysql_stmt_attr_set(self->stmt, STMT_ATTR_PREFETCH_ROWS, &self->fetch_rows);
+    }
+
     if (self->reprepare)
     {
         mysql_stmt_attr_set(self->stmt, STMT_ATTR_CURSOR_TYPE, &self->cursor_type);
@@ -1106,6 +1762,8 @@ MrdbCursor_execute_binary(MrdbCursor *self)
 
     if (!(buf= self->connection->mysql->methods->db_execute_generate_request(self->stmt, &buflen, 1)))
         goto error;
+    /* request was generated to validate the parameters only */
+    free(buf);
 
     if ((rc= Mrdb_execute_direct(self, self->parseinfo.statement, self->parseinfo.statement_len)))
     {
@@ -1142,6 +1800,7 @@ MrdbCursor_execute_text(MrdbCursor *self, PyObject *stmt)
         return NULL;
     }
     db= self->connection->mysql;
+    MrdbConnection_ClosePendingStatements(self->connection);
 
     MARIADB_BEGIN_ALLOW_THREADS(self->connection);
     rc= mysql_send_query(db, statement, (long)statement_len);
@@ -1182,14 +1841,20 @@ MrdbCursor_readresponse(MrdbCursor *self)
 }
 
 static PyObject *
-MrdbCursor_execute_bulk(MrdbCursor *self)
+MrdbCursor_execute_bulk(MrdbCursor *self, PyObject *args)
 {
     int rc;
     unsigned char *buf= NULL;
     size_t buflen;
+    uint8_t is_columnar= 0;
+    Py_ssize_t offset= 0;
+    unsigned long long max_bytes= 0;
 
     MARIADB_CHECK_STMT(self);
 
+    if (!PyArg_ParseTuple(args, "|bnK", &is_columnar, &offset, &max_bytes))
+        return NULL;
+
     if (PyErr_Occurred())
     {
         return NULL;
@@ -1208,17 +1873,21 @@ MrdbCursor_execute_bulk(MrdbCursor *self)
             mariadb_throw_exception(self->connection->mysql, NULL, 0, NULL);
             goto error;
         }
+        self->reprepare= 1;
     }
-    if (mariadb_check_bulk_parameters(self, self->data))
+    /* parameters are bound column-wise: all values were converted
+       before (or point to the buffers of columnar data), so no Python
+       calls are required while sending. If max_bytes was specified,
+       only the rows which fit into one request will be bound. */
+    if (is_columnar ?
+        mariadb_bind_bulk_columns(self, self->data, offset, (size_t)max_bytes) :
+        mariadb_bind_bulk_parameters(self, self->data, offset, (size_t)max_bytes))
         goto error;
 
-    /* If the server doesn't support bulk execution (< 10.2.6),
-       we need to call a fallback routine */
     if (self->reprepare)
     {
       mysql_stmt_attr_set(self->stmt, STMT_ATTR_PREBIND_PARAMS, &self->parseinfo.paramcount);
       mysql_stmt_attr_set(self->stmt, STMT_ATTR_CB_USER_DATA, (void *)self);
-      mysql_stmt_attr_set(self->stmt, STMT_ATTR_CB_PARAM, mariadb_param_update);
     }
     mysql_stmt_attr_set(self->stmt, STMT_ATTR_ARRAY_SIZE, &self->array_size);
 
@@ -1229,8 +1898,12 @@ MrdbCursor_execute_bulk(MrdbCursor *self)
         mariadb_throw_exception(self->stmt, NULL, 1, NULL);
         goto error;
     }
+    /* request was generated to validate the parameters only */
+    free(buf);
 
-    if ((rc= Mrdb_execute_direct(self, self->parseinfo.statement, self->parseinfo.statement_len)))
+    rc= Mrdb_execute_direct(self, self->parseinfo.statement, self->parseinfo.statement_len);
+    mariadb_free_bulk_parameters(self);
+    if (rc)
     {
          mariadb_throw_exception(self->stmt, NULL, 1, NULL);
          goto error;
@@ -1248,63 +1921,312 @@ MrdbCursor_execute_bulk(MrdbCursor *self)
       self->lastrow_id= CURSOR_INSERT_ID(self);
       MARIADB_FREE_MEM(self->values);
     }
-    Py_RETURN_NONE;
+    /* number of rows which were sent */
+    return PyLong_FromUnsignedLong(self->array_size);
 error:
     MrdbCursor_clear(self, 0);
     return NULL;
 }
 
+/* {{{ MrdbCursor_FetchRows
+   Fetches up to row_count rows into a list. For buffered result sets
+   the number of remaining rows is known, so the list will be allocated
+   with the exact size and filled without resizing.
+   If max_bytes was specified, fetching stops after the raw size of the
+   fetched rows reached max_bytes. */
 static PyObject *
-MrdbCursor_fetchrows(MrdbCursor *self, PyObject *rows)
+MrdbCursor_FetchRows(MrdbCursor *self, uint64_t row_count,
+                     uint64_t max_bytes)
 {
     PyObject *List;
-    unsigned int field_count= self->field_count;
-    uint64_t row_count;
+    MrdbRow_Build build_row;
+    Py_ssize_t size= 0, i= 0;
+    uint64_t fetched_bytes= 0;
+    uint8_t measure_bytes= self->measure_bytes;
+    int rc= 0;
+
+    MrdbCursor_DropReadAhead(self);
 
     MARIADB_CHECK_STMT_FETCH(self);
+    if (PyErr_Occurred())
+    {
+        return NULL;
+    }
 
-    if (!field_count)
+    if (!self->field_count)
     {
         mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
                 "Cursor doesn't have a result set");
         return NULL;
     }
 
+    /* with a byte limit the number of rows isn't known in advance */
+    if (self->is_buffered && !max_bytes)
+    {
+        uint64_t num_rows= CURSOR_NUM_ROWS(self);
+        uint64_t remaining= num_rows > self->row_number ?
+                            num_rows - self->row_number : 0;
+
+        if (remaining > row_count)
+            remaining= row_count;
+        if (remaining > PY_SSIZE_T_MAX / sizeof(PyObject *))
+            remaining= 0;
+        size= (Py_ssize_t)remaining;
+    }
+
+    if (!(List= PyList_New(size)))
+    {
+        return NULL;
+    }
+
+    build_row= mariadb_row_builder(self);
+    if (max_bytes)
+        self->measure_bytes= 1;
+
+    for (; (uint64_t)i < row_count && !(rc= MrdbCursor_fetchinternal(self)); i++)
+    {
+        PyObject *Row;
+
+        self->row_number++;
+
+        if (!(Row= build_row(self)))
+        {
+            rc= -1;
+            break;
+        }
+
+        if (i < size)
+        {
+            PyList_SET_ITEM(List, i, Row);
+        } else {
+            rc= PyList_Append(List, Row);
+            /* CONPY-99: Decrement Row to prevent memory leak */
+            Py_DECREF(Row);
+            if (rc)
+                break;
+        }
+
+        if (max_bytes && (fetched_bytes+= self->row_bytes) >= max_bytes)
+        {
+            i++;
+            break;
+        }
+    }
+    self->measure_bytes= measure_bytes;
+
+    /* less rows than expected (e.g. after seek) */
+    if (rc >= 0 && i < size && PyList_SetSlice(List, i, size, NULL))
+    {
+        rc= -1;
+    }
+
+    if (rc < 0)
+    {
+        Py_DECREF(List);
+        return NULL;
+    }
+    self->row_count= CURSOR_NUM_ROWS(self);
+    return List;
+}
+/* }}} */
+
+static PyObject *
+MrdbCursor_fetchrows(MrdbCursor *self, PyObject *args)
+{
+    PyObject *rows;
+    unsigned long long max_bytes= 0;
+
+    if (!PyArg_ParseTuple(args, "O|K", &rows, &max_bytes))
+        return NULL;
+
     if (!CHECK_TYPE_NO_NONE(rows, &PyLong_Type)) {
         PyErr_SetString(PyExc_TypeError, "Parameter must be an integer value");
         return NULL;
     }
 
-    row_count= (uint64_t)PyLong_AsLongLong(rows);
+    return MrdbCursor_FetchRows(self, (uint64_t)PyLong_AsLongLong(rows),
+                                (uint64_t)max_bytes);
+}
 
-    if (!(List= PyList_New(0)))
+/* {{{ MrdbCursor_check_closed
+   Unbuffered cursors can't fetch rows after cursor or connection were
+   closed */
+static int
+MrdbCursor_check_closed(MrdbCursor *self)
+{
+    if (!self->is_buffered &&
+        (self->closed || !self->connection->mysql))
     {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                self->connection->closed ?
+                "Invalid connection or not connected" :
+                "Cursor is closed");
+        return 1;
+    }
+    return 0;
+}
+/* }}} */
+
+static PyObject *
+MrdbCursor_fetchall(MrdbCursor *self)
+{
+    if (MrdbCursor_check_closed(self))
+        return NULL;
+    return MrdbCursor_FetchRows(self, UINT64_MAX, 0);
+}
+
+/* {{{ MrdbCursor_iter
+   Cursor state will be checked once when iteration starts */
+static PyObject *
+MrdbCursor_iter(MrdbCursor *self)
+{
+    if (MrdbCursor_check_closed(self))
+        return NULL;
+
+    if (!self->field_count)
+    {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Cursor doesn't have a result set");
         return NULL;
     }
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+/* }}} */
 
-    for (uint64_t i=0; i < row_count && !MrdbCursor_fetchinternal(self); i++)
+/* {{{ MrdbCursor_iternext
+   For buffered result sets rows will be decoded in batches of
+   MRDB_READ_AHEAD_ROWS. row_number always reflects the rows which were
+   returned to the caller */
+static PyObject *
+MrdbCursor_iternext(MrdbCursor *self)
+{
+    PyObject *row;
+
+    if (!self->read_ahead)
     {
-        uint32_t j;
-        PyObject *Row;
+        if (!self->is_buffered)
+        {
+            if ((row= MrdbCursor_fetchone(self)) == Py_None)
+            {
+                Py_DECREF(row);
+                return NULL;
+            }
+            return row;
+        }
+        if (!(self->read_ahead= MrdbCursor_FetchRows(self, MRDB_READ_AHEAD_ROWS, 0)))
+            return NULL;
+        self->row_number-= PyList_GET_SIZE(self->read_ahead);
+        self->read_ahead_pos= 0;
+    }
 
-        self->row_number++;
+    if (self->read_ahead_pos >= PyList_GET_SIZE(self->read_ahead))
+    {
+        Py_CLEAR(self->read_ahead);
+        return NULL;
+    }
+
+    /* pass ownership of the row to the caller */
+    row= PyList_GET_ITEM(self->read_ahead, self->read_ahead_pos);
+    PyList_SET_ITEM(self->read_ahead, self->read_ahead_pos, NULL);
+    self->read_ahead_pos++;
+    self->row_number++;
 
-        if (!(Row= mariadb_get_sequence_or_tuple(self)))
+    if (self->read_ahead_pos == PyList_GET_SIZE(self->read_ahead))
+        Py_CLEAR(self->read_ahead);
+    return row;
+}
+/* }}} */
+
+/* {{{ MrdbCursor_FetchColumns
+   Fetches up to row_count rows into column buffers and returns a list
+   with a column buffer for each column. If decimal128 was specified,
+   DECIMAL values will be stored as 128-bit integers (Arrow export) */
+PyObject *
+MrdbCursor_FetchColumns(MrdbCursor *self, uint64_t row_count,
+                        uint8_t decimal128)
+{
+    PyObject *List;
+    unsigned int field_count= self->field_count;
+    uint8_t fetch_raw= self->fetch_raw;
+    uint32_t j;
+    int rc= 0;
+
+    MrdbCursor_DropReadAhead(self);
+
+    MARIADB_CHECK_STMT_FETCH(self);
+    if (PyErr_Occurred())
+        return NULL;
+
+    if (!field_count)
+    {
+        mariadb_throw_exception(NULL, Mariadb_ProgrammingError, 0,
+                "Cursor doesn't have a result set");
+        return NULL;
+    }
+
+    if (!self->raw_values &&
+        !(self->raw_values= (MrdbRawValue *)PyMem_RawCalloc(field_count,
+                                                sizeof(MrdbRawValue))))
+        return PyErr_NoMemory();
+
+    if (!(List= PyList_New(field_count)))
+        return NULL;
+
+    for (j=0; j < field_count; j++)
+    {
+        PyObject *column;
+
+        if (!(column= MrdbColumnBuffer_New(self->plan, j, &self->fields[j],
+                                            decimal128)))
         {
+            Py_DECREF(List);
             return NULL;
         }
+        PyList_SET_ITEM(List, j, column);
+    }
+
+    /* values are converted from raw column data, no Python objects
+       will be created for single values */
+    self->fetch_raw= 1;
+    for (uint64_t i=0; i < row_count && !(rc= MrdbCursor_fetchinternal(self)); i++)
+    {
+        self->row_number++;
 
         for (j=0; j < field_count; j++)
         {
-            ma_set_result_column_value(self, Row, j);
+            if (MrdbColumnBuffer_Append(
+                    (MrdbColumnBuffer *)PyList_GET_ITEM(List, j),
+                    &self->raw_values[j]))
+            {
+                rc= -1;
+                break;
+            }
         }
-        PyList_Append(List, Row);
-        /* CONPY-99: Decrement Row to prevent memory leak */
-        Py_DECREF(Row);
+        if (rc)
+            break;
+    }
+    self->fetch_raw= fetch_raw;
+
+    if (rc < 0)
+    {
+        Py_DECREF(List);
+        return NULL;
     }
     self->row_count= CURSOR_NUM_ROWS(self);
     return List;
 }
+/* }}} */
+
+static PyObject *
+MrdbCursor_fetch_columns(MrdbCursor *self, PyObject *rows)
+{
+    if (!CHECK_TYPE_NO_NONE(rows, &PyLong_Type)) {
+        PyErr_SetString(PyExc_TypeError, "Parameter must be an integer value");
+        return NULL;
+    }
+    return MrdbCursor_FetchColumns(self, (uint64_t)PyLong_AsLongLong(rows), 0);
+}
 
 static PyObject *
 MrdbCursor_check_text_types(MrdbCursor *self)
@@ -365,18 +365,22 @@ cont:
         if (is_batch)
         {
             /* Do we have an insert statement ? */
-            if (!p->is_insert && check_keyword(a, end, "INSERT", 6))
+            if (!p->is_insert && (check_keyword(a, end, "INSERT", 6) ||
+                                  check_keyword(a, end, "REPLACE", 7)))
             {
                 if (lastchar == 0 ||
                     (IS_WHITESPACE(lastchar)) ||
                      lastchar == '/')
                 {
                     p->is_insert = 1;
-                    a += 7;
+                    a += (toupper(*a) == 'I') ? 7 : 8;
                 }
             }
 
-            if (p->is_insert && check_keyword(a, end, "VALUES", 6))
+            /* first VALUES keyword only: VALUES() might be used in an
+               ON DUPLICATE KEY UPDATE clause */
+            if (p->is_insert && !p->value_ofs &&
+                check_keyword(a, end, "VALUES", 6))
             {
                 p->value_ofs = a + 7;
                 a += 7;
@@ -399,6 +403,11 @@ cont:
             if (p->command == SQL_NONE)
               p->command= SQL_OTHER;
           }
+          /* INSERT, REPLACE or DELETE ... RETURNING */
+          if (!p->has_returning &&
+              (IS_WHITESPACE(lastchar) || lastchar == ')') &&
+              check_keyword(a, end, "RETURNING", 9))
+            p->has_returning= 1;
 
         }
         lastchar= *a;
@@ -408,3 +417,71 @@ cont:
     p->statement.length= end - p->statement.str + 1;
     return 0;
 }
+
+/* {{{ MrdbParser_get_row
+   Batch mode only: Determines offset and length of the row constructor
+   after the VALUES keyword, e.g. "(?, ?, NOW())". All placeholders must
+   be part of the row constructor, and the statement must not contain
+   further rows, so it can be rewritten into a multi-row statement by
+   repeating the row constructor.
+   Returns 1 if the statement can't be rewritten. */
+uint8_t
+MrdbParser_get_row(MrdbParser *p, size_t *ofs, size_t *len)
+{
+    char *a, *start, *end;
+    char quote= 0;
+    uint32_t depth= 0;
+    Py_ssize_t first, last;
+
+    if (!p->value_ofs || !p->param_count ||
+        PyList_GET_SIZE(p->param_list) != p->param_count)
+        return 1;
+
+    a= p->value_ofs;
+    end= p->statement.str + p->statement.length;
+    while (a < end && IS_WHITESPACE(*a))
+        a++;
+    if (a == end || *a != '(')
+        return 1;
+    start= a;
+
+    for (; a < end; a++)
+    {
+        if (quote)
+        {
+            if (*a == '\\' && quote != '`' && a + 1 < end)
+                a++;
+            else if (*a == quote)
+                quote= 0;
+            continue;
+        }
+        if (*a == '\'' || *a == '\"' || *a == '`')
+            quote= *a;
+        else if (*a == '(')
+            depth++;
+        else if (*a == ')' && !--depth)
+            break;
+        /* comments are not supported */
+        else if (*a == '#' || (a + 1 < end &&
+                 ((*a == '/' && *(a + 1) == '*') ||
+                  (*a == '-' && *(a + 1) == '-'))))
+            return 1;
+    }
+    if (a == end)
+        return 1;
+
+    *ofs= start - p->statement.str;
+    *len= a - start + 1;
+
+    /* statement contains multiple rows already */
+    for (a++; a < end && IS_WHITESPACE(*a); a++);
+    if (a < end && *a == ',')
+        return 1;
+
+    first= PyLong_AsSsize_t(PyList_GET_ITEM(p->param_list, 0));
+    last= PyLong_AsSsize_t(PyList_GET_ITEM(p->param_list, p->param_count - 1));
+    if (first < (Py_ssize_t)*ofs || last >= (Py_ssize_t)(*ofs + *len))
+        return 1;
+    return 0;
+}
+/* }}} */
@@ -0,0 +1,366 @@
+/*****************************************************************************
+  Copyright (C) 2018-2020 Georg Richter and MariaDB Corporation AB
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+ ****************************************************************************/
+#include "mariadb_python.h"
+
+/* {{{ mrdb_prefetch_store
+   Copies the raw values of the current row into a slot. The data buffer
+   of a slot will be reused for subsequent rows. Text protocol values will
+   be zero terminated, since some decoders rely on that.
+   Called without holding the GIL. */
+static uint8_t
+mrdb_prefetch_store(MrdbPrefetch *prefetch, MrdbPrefetchSlot *slot,
+                    MrdbRawValue *raw)
+{
+    uint8_t is_text= prefetch->plan->is_text;
+    size_t length= 0;
+    unsigned char *data;
+    uint32_t i;
+
+    for (i= 0; i < prefetch->field_count; i++)
+    {
+        if (raw[i].data)
+            length+= raw[i].length + is_text;
+    }
+
+    if (length > slot->data_size)
+    {
+        if (!(data= (unsigned char *)PyMem_RawRealloc(slot->data, length)))
+            return 1;
+        slot->data= data;
+        slot->data_size= length;
+    }
+
+    data= slot->data;
+    for (i= 0; i < prefetch->field_count; i++)
+    {
+        slot->raw[i].length= raw[i].length;
+        if (!raw[i].data)
+        {
+            slot->raw[i].data= NULL;
+            continue;
+        }
+        memcpy(data, raw[i].data, raw[i].length);
+        slot->raw[i].data= data;
+        data+= raw[i].length;
+        if (is_text)
+            *data++= 0;
+    }
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_prefetch_read
+   Reads the next row from server. Returns 0 on success, 1 if all rows
+   were read and -1 on error */
+static int
+mrdb_prefetch_read(MrdbPrefetch *prefetch, MrdbRawValue **raw)
+{
+    MrdbCursor *cursor= prefetch->cursor;
+
+    if (prefetch->plan->is_text)
+    {
+        MYSQL_ROW row;
+        unsigned long *lengths;
+        uint32_t i;
+
+        if (!(row= mysql_fetch_row(cursor->result)))
+            return mysql_errno(cursor->connection->mysql) ? -1 : 1;
+        lengths= mysql_fetch_lengths(cursor->result);
+        for (i= 0; i < prefetch->field_count; i++)
+        {
+            prefetch->current[i].data= (unsigned char *)row[i];
+            prefetch->current[i].length= lengths[i];
+        }
+    } else {
+        /* raw values will be set by mariadb_prefetch_callback */
+        int rc= mysql_stmt_fetch(cursor->stmt);
+
+        if (rc == MYSQL_NO_DATA)
+            return 1;
+        if (rc == 1)
+            return -1;
+    }
+    *raw= prefetch->current;
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_prefetch_thread
+   Reader thread: fills the ring until all rows were read, an error
+   occurred or the reader was stopped. If the ring is full, the reader
+   waits until the cursor consumed a row. */
+static void
+mrdb_prefetch_thread(void *arg)
+{
+    MrdbPrefetch *prefetch= (MrdbPrefetch *)arg;
+
+    pthread_mutex_lock(&prefetch->lock);
+    while (!prefetch->stop)
+    {
+        MrdbPrefetchSlot *slot;
+        MrdbRawValue *raw;
+        int rc;
+
+        if (prefetch->count == prefetch->capacity)
+        {
+            pthread_cond_wait(&prefetch->not_full, &prefetch->lock);
+            continue;
+        }
+
+        /* the tail slot isn't accessed by the cursor */
+        slot= &prefetch->slots[(prefetch->head + prefetch->count) %
+                               prefetch->capacity];
+        pthread_mutex_unlock(&prefetch->lock);
+
+        if (!(rc= mrdb_prefetch_read(prefetch, &raw)) &&
+            mrdb_prefetch_store(prefetch, slot, raw))
+            rc= -2;
+
+        pthread_mutex_lock(&prefetch->lock);
+        if (rc)
+        {
+            if (rc == 1)
+                prefetch->eof= 1;
+            else
+                prefetch->error= (rc == -1) ? PREFETCH_ERROR_SERVER :
+                                              PREFETCH_ERROR_MEMORY;
+            break;
+        }
+        prefetch->count++;
+        pthread_cond_signal(&prefetch->not_empty);
+    }
+    prefetch->running= 0;
+    pthread_cond_broadcast(&prefetch->not_empty);
+    pthread_mutex_unlock(&prefetch->lock);
+}
+/* }}} */
+
+/* {{{ MrdbPrefetch_Start
+   Starts the background reader for an unbuffered result set. Returns 1
+   if an error occurred. */
+uint8_t
+MrdbPrefetch_Start(MrdbCursor *self)
+{
+    MrdbPrefetch *prefetch;
+    uint32_t i;
+
+    if (!(prefetch= (MrdbPrefetch *)PyMem_RawCalloc(1, sizeof(MrdbPrefetch))))
+        goto error;
+    self->prefetch= prefetch;
+
+    prefetch->cursor= self;
+    prefetch->plan= self->plan;
+    prefetch->field_count= self->field_count;
+    prefetch->capacity= self->prefetch_capacity;
+
+    if (!(prefetch->slots= (MrdbPrefetchSlot *)PyMem_RawCalloc(prefetch->capacity,
+                                                   sizeof(MrdbPrefetchSlot))) ||
+        !(prefetch->current= (MrdbRawValue *)PyMem_RawCalloc(
+                                 (size_t)(prefetch->capacity + 1) *
+                                 prefetch->field_count, sizeof(MrdbRawValue))))
+        goto error;
+
+    for (i= 0; i < prefetch->capacity; i++)
+    {
+        prefetch->slots[i].raw= prefetch->current +
+                                (size_t)(i + 1) * prefetch->field_count;
+    }
+
+    pthread_mutex_init(&prefetch->lock, NULL);
+    pthread_cond_init(&prefetch->not_empty, NULL);
+    pthread_cond_init(&prefetch->not_full, NULL);
+
+    if (!self->parseinfo.is_text)
+    {
+        mysql_stmt_attr_set(self->stmt, STMT_ATTR_CB_USER_DATA, (void *)prefetch);
+        mysql_stmt_attr_set(self->stmt, STMT_ATTR_CB_RESULT,
+                            mariadb_prefetch_callback);
+    }
+
+    prefetch->running= 1;
+    self->connection->prefetch= prefetch;
+    if (PyThread_start_new_thread(mrdb_prefetch_thread, (void *)prefetch) ==
+        PYTHREAD_INVALID_THREAD_ID)
+    {
+        prefetch->running= 0;
+        MrdbPrefetch_Free(self);
+        mariadb_throw_exception(NULL, Mariadb_InterfaceError, 0,
+                                "Can't start prefetch thread");
+        return 1;
+    }
+    return 0;
+error:
+    MrdbPrefetch_Free(self);
+    PyErr_NoMemory();
+    return 1;
+}
+/* }}} */
+
+/* {{{ MrdbPrefetch_Stop
+   Stops the reader and waits until it finished. Rows which were already
+   read remain in the ring, further rows will be fetched by the cursor
+   directly. */
+void
+MrdbPrefetch_Stop(MrdbPrefetch *prefetch)
+{
+    MrdbCursor *cursor= prefetch->cursor;
+
+    Py_BEGIN_ALLOW_THREADS;
+    pthread_mutex_lock(&prefetch->lock);
+    prefetch->stop= 1;
+    pthread_cond_signal(&prefetch->not_full);
+    while (prefetch->running)
+        pthread_cond_wait(&prefetch->not_empty, &prefetch->lock);
+    pthread_mutex_unlock(&prefetch->lock);
+    Py_END_ALLOW_THREADS;
+
+    if (cursor->connection->prefetch == prefetch)
+    {
+        cursor->connection->prefetch= NULL;
+        if (!cursor->parseinfo.is_text && cursor->stmt)
+        {
+            mysql_stmt_attr_set(cursor->stmt, STMT_ATTR_CB_USER_DATA,
+                                (void *)cursor);
+            mysql_stmt_attr_set(cursor->stmt, STMT_ATTR_CB_RESULT,
+                                field_fetch_callback);
+        }
+    }
+}
+/* }}} */
+
+/* {{{ MrdbPrefetch_Free */
+void
+MrdbPrefetch_Free(MrdbCursor *self)
+{
+    MrdbPrefetch *prefetch= self->prefetch;
+    uint32_t i;
+
+    if (!prefetch)
+        return;
+
+    /* lock and conditions are initialized after all buffers were
+       allocated */
+    if (prefetch->current)
+    {
+        MrdbPrefetch_Stop(prefetch);
+        pthread_cond_destroy(&prefetch->not_full);
+        pthread_cond_destroy(&prefetch->not_empty);
+        pthread_mutex_destroy(&prefetch->lock);
+    }
+    if (prefetch->slots)
+    {
+        for (i= 0; i < prefetch->capacity; i++)
+            MARIADB_FREE_MEM(prefetch->slots[i].data);
+        MARIADB_FREE_MEM(prefetch->slots);
+    }
+    MARIADB_FREE_MEM(prefetch->current);
+    MARIADB_FREE_MEM(self->prefetch);
+}
+/* }}} */
+
+/* {{{ MrdbPrefetch_Fetch
+   Returns the next row from the ring: Values will be decoded into
+   self->values, or, if raw values were requested, copied to
+   self->raw_values. The slot will be released with the next call.
+   rc is set to 0 if a row was fetched, 1 if all rows were read and -1
+   if an error occurred.
+   Returns 0 if the reader was stopped and all rows of the ring were
+   consumed: In this case the cursor needs to fetch directly. */
+uint8_t
+MrdbPrefetch_Fetch(MrdbCursor *self, int *rc)
+{
+    MrdbPrefetch *prefetch= self->prefetch;
+    MrdbPrefetchSlot *slot;
+    uint32_t i, j;
+
+    pthread_mutex_lock(&prefetch->lock);
+    if (prefetch->held)
+    {
+        prefetch->head= (prefetch->head + 1) % prefetch->capacity;
+        prefetch->count--;
+        prefetch->held= 0;
+        pthread_cond_signal(&prefetch->not_full);
+    }
+    if (!prefetch->count && prefetch->running)
+    {
+        Py_BEGIN_ALLOW_THREADS;
+        while (!prefetch->count && prefetch->running)
+            pthread_cond_wait(&prefetch->not_empty, &prefetch->lock);
+        Py_END_ALLOW_THREADS;
+    }
+    if (!prefetch->count)
+    {
+        pthread_mutex_unlock(&prefetch->lock);
+        if (prefetch->error == PREFETCH_ERROR_SERVER)
+        {
+            prefetch->error= PREFETCH_ERROR_NONE;
+            if (self->parseinfo.is_text)
+                mariadb_throw_exception(self->connection->mysql, NULL, 0, NULL);
+            else
+                mariadb_throw_exception(self->stmt, NULL, 1, NULL);
+            *rc= -1;
+            return 1;
+        }
+        if (prefetch->error == PREFETCH_ERROR_MEMORY)
+        {
+            prefetch->error= PREFETCH_ERROR_NONE;
+            PyErr_NoMemory();
+            *rc= -1;
+            return 1;
+        }
+        if (prefetch->eof)
+        {
+            *rc= 1;
+            return 1;
+        }
+        return 0;
+    }
+    prefetch->held= 1;
+    slot= &prefetch->slots[prefetch->head];
+    pthread_mutex_unlock(&prefetch->lock);
+
+    if (self->measure_bytes)
+    {
+        for (i= 0; i < self->field_count; i++)
+            self->row_bytes+= slot->raw[i].length;
+    }
+
+    if (self->fetch_raw)
+    {
+        memcpy(self->raw_values, slot->raw,
+               self->field_count * sizeof(MrdbRawValue));
+        *rc= 0;
+        return 1;
+    }
+
+    for (i= 0; i < self->field_count; i++)
+    {
+        if (!(self->values[i]= mariadb_decode_raw_value(self->plan, i,
+                                                         &slot->raw[i])))
+        {
+            for (j= 0; j < i; j++)
+                Py_CLEAR(self->values[j]);
+            *rc= -1;
+            return 1;
+        }
+    }
+    *rc= 0;
+    return 1;
+}
+/* }}} */
@@ -0,0 +1,296 @@
+/*****************************************************************************
+  Copyright (C) 2018-2020 Georg Richter and MariaDB Corporation AB
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+ ****************************************************************************/
+#include "mariadb_python.h"
+#include "docs/row.h"
+
+/* {{{ MrdbRow_New
+   Creates a lazy row from the raw values of the current row. The raw
+   data will be copied, so the row stays valid after the result set was
+   freed or the next row was fetched */
+PyObject *
+MrdbRow_New(MrdbColumnPlan *plan, MrdbRawValue *raw)
+{
+    MrdbRow *self;
+    uint32_t i, count= plan->column_count;
+    size_t data_length= 0;
+    unsigned char *data;
+
+    /* text protocol values are zero terminated, some decoders
+       (e.g. for floating point values) rely on that */
+    for (i=0; i < count; i++)
+    {
+        if (raw[i].data)
+            data_length+= raw[i].length + plan->is_text;
+    }
+
+    if (!(self= PyObject_New(MrdbRow, &MrdbRow_Type)))
+        return NULL;
+
+    Py_INCREF(plan);
+    self->plan= plan;
+
+    /* decoded values, raw values and data are stored in one block */
+    if (!(self->values= (PyObject **)PyMem_RawCalloc(1,
+                        count * (sizeof(PyObject *) + sizeof(MrdbRawValue)) +
+                        data_length)))
+    {
+        self->raw= NULL;
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    self->raw= (MrdbRawValue *)(self->values + count);
+    data= (unsigned char *)(self->raw + count);
+
+    for (i=0; i < count; i++)
+    {
+        if (!raw[i].data)
+            continue;
+        memcpy(data, raw[i].data, raw[i].length);
+        self->raw[i].data= data;
+        self->raw[i].length= raw[i].length;
+        data+= raw[i].length + plan->is_text;
+    }
+    return (PyObject *)self;
+}
+/* }}} */
+
+/* {{{ MrdbRow_dealloc */
+static void
+MrdbRow_dealloc(MrdbRow *self)
+{
+    uint32_t i;
+
+    if (self->values)
+    {
+        for (i=0; i < self->plan->column_count; i++)
+            Py_XDECREF(self->values[i]);
+        MARIADB_FREE_MEM(self->values);
+    }
+    Py_XDECREF(self->plan);
+    PyObject_Del(self);
+}
+/* }}} */
+
+static Py_ssize_t
+MrdbRow_length(MrdbRow *self)
+{
+    return (Py_ssize_t)self->plan->column_count;
+}
+
+/* {{{ MrdbRow_item
+   Returns the value of the specified column, the value will be decoded
+   on first access */
+static PyObject *
+MrdbRow_item(MrdbRow *self, Py_ssize_t column)
+{
+    if (column < 0 || column >= (Py_ssize_t)self->plan->column_count)
+    {
+        PyErr_SetString(PyExc_IndexError, "row index out of range");
+        return NULL;
+    }
+    if (!self->values[column] &&
+        !(self->values[column]= mariadb_decode_raw_value(self->plan,
+                                                         (uint32_t)column,
+                                                         &self->raw[column])))
+        return NULL;
+
+    Py_INCREF(self->values[column]);
+    return self->values[column];
+}
+/* }}} */
+
+/* {{{ MrdbRow_subscript
+   Columns can be accessed by index, slice or column name */
+static PyObject *
+MrdbRow_subscript(MrdbRow *self, PyObject *key)
+{
+    Py_ssize_t column;
+
+    if (PyUnicode_Check(key))
+    {
+        PyObject *index= self->plan->column_index ?
+                         PyDict_GetItemWithError(self->plan->column_index, key) :
+                         NULL;
+        if (!index)
+        {
+            if (!PyErr_Occurred())
+                PyErr_SetObject(PyExc_KeyError, key);
+            return NULL;
+        }
+        return MrdbRow_item(self, PyLong_AsSsize_t(index));
+    }
+
+    if (PySlice_Check(key))
+    {
+        Py_ssize_t start, stop, step, i, slice_length;
+        PyObject *tuple;
+
+        if (PySlice_Unpack(key, &start, &stop, &step) < 0)
+            return NULL;
+        slice_length= PySlice_AdjustIndices(self->plan->column_count,
+                                            &start, &stop, step);
+        if (!(tuple= PyTuple_New(slice_length)))
+            return NULL;
+        for (i=0; i < slice_length; i++, start+= step)
+        {
+            PyObject *value;
+
+            if (!(value= MrdbRow_item(self, start)))
+            {
+                Py_DECREF(tuple);
+                return NULL;
+            }
+            PyTuple_SET_ITEM(tuple, i, value);
+        }
+        return tuple;
+    }
+
+    if (PyIndex_Check(key))
+    {
+        if ((column= PyNumber_AsSsize_t(key, PyExc_IndexError)) == -1 &&
+            PyErr_Occurred())
+            return NULL;
+        if (column < 0)
+            column+= self->plan->column_count;
+        return MrdbRow_item(self, column);
+    }
+
+    PyErr_Format(PyExc_TypeError,
+                 "row indices must be integers, slices or column names, not %.200s",
+                 Py_TYPE(key)->tp_name);
+    return NULL;
+}
+/* }}} */
+
+/* {{{ MrdbRow_materialize
+   Decodes all columns and returns the row as tuple */
+static PyObject *
+MrdbRow_materialize(MrdbRow *self)
+{
+    PyObject *tuple;
+    uint32_t i;
+
+    if (!(tuple= PyTuple_New(self->plan->column_count)))
+        return NULL;
+
+    for (i=0; i < self->plan->column_count; i++)
+    {
+        PyObject *value;
+
+        if (!(value= MrdbRow_item(self, i)))
+        {
+            Py_DECREF(tuple);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(tuple, i, value);
+    }
+    return tuple;
+}
+/* }}} */
+
+static PyObject *
+MrdbRow_repr(MrdbRow *self)
+{
+    PyObject *tuple, *repr;
+
+    if (!(tuple= MrdbRow_materialize(self)))
+        return NULL;
+    repr= PyUnicode_FromFormat("mariadb.LazyRow%R", tuple);
+    Py_DECREF(tuple);
+    return repr;
+}
+
+/* {{{ MrdbRow_richcompare
+   Lazy rows compare like tuples */
+static PyObject *
+MrdbRow_richcompare(MrdbRow *self, PyObject *other, int op)
+{
+    PyObject *tuple, *other_tuple= NULL, *ret;
+
+    if (Py_TYPE(other) == &MrdbRow_Type)
+    {
+        if (!(other_tuple= MrdbRow_materialize((MrdbRow *)other)))
+            return NULL;
+        other= other_tuple;
+    }
+    else if (!PyTuple_Check(other))
+    {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    if (!(tuple= MrdbRow_materialize(self)))
+    {
+        Py_XDECREF(other_tuple);
+        return NULL;
+    }
+    ret= PyObject_RichCompare(tuple, other, op);
+    Py_DECREF(tuple);
+    Py_XDECREF(other_tuple);
+    return ret;
+}
+/* }}} */
+
+static Py_hash_t
+MrdbRow_hash(MrdbRow *self)
+{
+    PyObject *tuple;
+    Py_hash_t hash;
+
+    if (!(tuple= MrdbRow_materialize(self)))
+        return -1;
+    hash= PyObject_Hash(tuple);
+    Py_DECREF(tuple);
+    return hash;
+}
+
+static PyMethodDef MrdbRow_Methods[] =
+{
+    {"materialize", (PyCFunction)MrdbRow_materialize,
+        METH_NOARGS,
+        row_materialize__doc__},
+    {NULL} /* always last */
+};
+
+static PySequenceMethods MrdbRow_as_sequence=
+{
+    .sq_length= (lenfunc)MrdbRow_length,
+    .sq_item= (ssizeargfunc)MrdbRow_item,
+};
+
+static PyMappingMethods MrdbRow_as_mapping=
+{
+    .mp_length= (lenfunc)MrdbRow_length,
+    .mp_subscript= (binaryfunc)MrdbRow_subscript,
+};
+
+PyTypeObject MrdbRow_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mariadb.LazyRow",
+    .tp_basicsize= (Py_ssize_t)sizeof(MrdbRow),
+    .tp_dealloc= (destructor)MrdbRow_dealloc,
+    .tp_repr= (reprfunc)MrdbRow_repr,
+    .tp_as_sequence= &MrdbRow_as_sequence,
+    .tp_as_mapping= &MrdbRow_as_mapping,
+    .tp_hash= (hashfunc)MrdbRow_hash,
+    .tp_flags= Py_TPFLAGS_DEFAULT,
+    .tp_doc= row__doc__,
+    .tp_richcompare= (richcmpfunc)MrdbRow_richcompare,
+    .tp_methods= (struct PyMethodDef *)MrdbRow_Methods,
+};
@@ -0,0 +1,376 @@
+/*****************************************************************************
+  Copyright (C) 2018-2020 Georg Richter and MariaDB Corporation AB
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+ ****************************************************************************/
+#include "mariadb_python.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#define SPOOL_ERROR_NONE 0
+#define SPOOL_ERROR_SERVER 1
+#define SPOOL_ERROR_MEMORY 2
+#define SPOOL_ERROR_IO 3
+
+/* initial size of memory buffer and row index */
+#define SPOOL_INITIAL_SIZE 65536
+#define SPOOL_INITIAL_ROWS 1024
+
+/* {{{ mrdb_spool_read
+   Reads the next row from server into spool->raw. For binary protocol
+   the raw values will be set by field_fetch_callback.
+   Returns 0 on success, 1 if all rows were read and -1 on error */
+static int
+mrdb_spool_read(MrdbCursor *self)
+{
+    MrdbSpool *spool= self->spool;
+
+    if (spool->is_text)
+    {
+        MYSQL_ROW row;
+        unsigned long *lengths;
+        uint32_t i;
+
+        if (!(row= mysql_fetch_row(self->result)))
+            return mysql_errno(self->connection->mysql) ? -1 : 1;
+        lengths= mysql_fetch_lengths(self->result);
+        for (i= 0; i < spool->field_count; i++)
+        {
+            spool->raw[i].data= (unsigned char *)row[i];
+            spool->raw[i].length= lengths[i];
+        }
+    } else {
+        int rc= mysql_stmt_fetch(self->stmt);
+
+        if (rc == MYSQL_NO_DATA)
+            return 1;
+        if (rc == 1)
+            return -1;
+    }
+    return 0;
+}
+/* }}} */
+
+/* {{{ mrdb_spool_pack
+   Stores the raw values of the current row in packed format. Text
+   protocol values will be zero terminated, since some decoders rely
+   on that */
+static void
+mrdb_spool_pack(MrdbSpool *spool, unsigned char *dst)
+{
+    uint32_t i, length;
+
+    for (i= 0; i < spool->field_count; i++)
+    {
+        if (!spool->raw[i].data)
+        {
+            length= SPOOL_NULL_LENGTH;
+            memcpy(dst, &length, sizeof(uint32_t));
+            dst+= sizeof(uint32_t);
+            continue;
+        }
+        length= (uint32_t)spool->raw[i].length;
+        memcpy(dst, &length, sizeof(uint32_t));
+        dst+= sizeof(uint32_t);
+        memcpy(dst, spool->raw[i].data, length);
+        dst+= length;
+        if (spool->is_text)
+            *dst++= 0;
+    }
+}
+/* }}} */
+
+/* {{{ mrdb_spool_append
+   Appends the current row to the memory buffer, or to the temporary
+   file if the memory limit was exceeded. Returns SPOOL_ERROR_* */
+static uint8_t
+mrdb_spool_append(MrdbSpool *spool)
+{
+    size_t row_size= 0;
+    unsigned char *dst;
+    uint32_t i;
+
+    for (i= 0; i < spool->field_count; i++)
+    {
+        row_size+= sizeof(uint32_t);
+        if (spool->raw[i].data)
+            row_size+= spool->raw[i].length + spool->is_text;
+    }
+
+    if (spool->row_count == spool->offsets_size)
+    {
+        uint64_t new_size= spool->offsets_size ? spool->offsets_size * 2 :
+                                                 SPOOL_INITIAL_ROWS;
+        uint64_t *offsets;
+
+        if (!(offsets= (uint64_t *)PyMem_RawRealloc(spool->offsets,
+                                        (size_t)new_size * sizeof(uint64_t))))
+            return SPOOL_ERROR_MEMORY;
+        spool->offsets= offsets;
+        spool->offsets_size= new_size;
+    }
+    spool->offsets[spool->row_count]= spool->size;
+
+    /* memory limit exceeded: move the rows into a temporary file */
+    if (!spool->file && spool->size + row_size > spool->limit)
+    {
+        if (!(spool->file= tmpfile()))
+            return SPOOL_ERROR_IO;
+        if (spool->size &&
+            fwrite(spool->data, 1, spool->size, spool->file) != spool->size)
+            return SPOOL_ERROR_IO;
+        MARIADB_FREE_MEM(spool->data);
+        spool->data_size= 0;
+    }
+
+    if (spool->file)
+    {
+        if (row_size > spool->row_buffer_size)
+        {
+            if (!(dst= (unsigned char *)PyMem_RawRealloc(spool->row_buffer,
+                                                         row_size)))
+                return SPOOL_ERROR_MEMORY;
+            spool->row_buffer= dst;
+            spool->row_buffer_size= row_size;
+        }
+        dst= spool->row_buffer;
+    } else {
+        if (spool->size + row_size > spool->data_size)
+        {
+            size_t new_size= spool->data_size ? spool->data_size * 2 :
+                                                SPOOL_INITIAL_SIZE;
+
+            while (new_size < spool->size + row_size)
+                new_size*= 2;
+            if (new_size > spool->limit)
+                new_size= (size_t)spool->limit;
+            if (!(dst= (unsigned char *)PyMem_RawRealloc(spool->data,
+                                                         new_size)))
+                return SPOOL_ERROR_MEMORY;
+            spool->data= dst;
+            spool->data_size= new_size;
+        }
+        dst= spool->data + spool->size;
+    }
+
+    mrdb_spool_pack(spool, dst);
+    if (spool->file &&
+        fwrite(spool->row_buffer, 1, row_size, spool->file) != row_size)
+        return SPOOL_ERROR_IO;
+
+    spool->size+= row_size;
+    spool->row_count++;
+    return SPOOL_ERROR_NONE;
+}
+/* }}} */
+
+/* {{{ mrdb_spool_map
+   Maps the temporary file into memory. Returns SPOOL_ERROR_* */
+static uint8_t
+mrdb_spool_map(MrdbSpool *spool)
+{
+    MARIADB_FREE_MEM(spool->row_buffer);
+    spool->row_buffer_size= 0;
+
+    if (!spool->file || !spool->size)
+        return SPOOL_ERROR_NONE;
+
+    if (fflush(spool->file))
+        return SPOOL_ERROR_IO;
+#ifdef _WIN32
+    if (!(spool->mapping= CreateFileMapping(
+                 (HANDLE)_get_osfhandle(_fileno(spool->file)), NULL,
+                 PAGE_READONLY, 0, 0, NULL)) ||
+        !(spool->data= (unsigned char *)MapViewOfFile(spool->mapping,
+                                                      FILE_MAP_READ, 0, 0, 0)))
+        return SPOOL_ERROR_IO;
+#else
+    {
+        void *data= mmap(NULL, spool->size, PROT_READ, MAP_SHARED,
+                         fileno(spool->file), 0);
+
+        if (data == MAP_FAILED)
+            return SPOOL_ERROR_IO;
+        spool->data= (unsigned char *)data;
+    }
+#endif
+    spool->mapped= 1;
+    return SPOOL_ERROR_NONE;
+}
+/* }}} */
+
+/* {{{ MrdbSpool_Load
+   Reads all rows of the current result set into the spool. Must be
+   called after the column plan was initialized.
+   Returns 1 if an error occurred (exception is set) */
+uint8_t
+MrdbSpool_Load(MrdbCursor *self)
+{
+    MrdbSpool *spool;
+    MrdbRawValue *raw_values= self->raw_values;
+    uint8_t fetch_raw= self->fetch_raw;
+    uint8_t rc= SPOOL_ERROR_NONE;
+
+    if (!(spool= (MrdbSpool *)PyMem_RawCalloc(1, sizeof(MrdbSpool))))
+    {
+        PyErr_NoMemory();
+        return 1;
+    }
+    self->spool= spool;
+    spool->field_count= self->field_count;
+    spool->is_text= self->parseinfo.is_text;
+    spool->limit= self->buffer_limit;
+
+    if (!(spool->raw= (MrdbRawValue *)PyMem_RawCalloc(spool->field_count,
+                                                      sizeof(MrdbRawValue))))
+    {
+        MrdbSpool_Free(self);
+        PyErr_NoMemory();
+        return 1;
+    }
+
+    /* binary protocol: field_fetch_callback saves position and length
+       of the raw values only */
+    self->raw_values= spool->raw;
+    self->fetch_raw= 1;
+
+    MARIADB_BEGIN_ALLOW_THREADS(self->connection);
+    while (rc == SPOOL_ERROR_NONE)
+    {
+        int read= mrdb_spool_read(self);
+
+        if (read == 1)
+            break;
+        rc= (read < 0) ? SPOOL_ERROR_SERVER : mrdb_spool_append(spool);
+    }
+    if (rc == SPOOL_ERROR_NONE)
+        rc= mrdb_spool_map(spool);
+    MARIADB_END_ALLOW_THREADS(self->connection);
+
+    self->raw_values= raw_values;
+    self->fetch_raw= fetch_raw;
+    self->row_bytes= 0;
+
+    switch (rc) {
+        case SPOOL_ERROR_NONE:
+            return 0;
+        case SPOOL_ERROR_SERVER:
+            if (spool->is_text)
+                mariadb_throw_exception(self->connection->mysql, NULL, 0, NULL);
+            else
+                mariadb_throw_exception(self->stmt, NULL, 1, NULL);
+            break;
+        case SPOOL_ERROR_MEMORY:
+            PyErr_NoMemory();
+            break;
+        default:
+            PyErr_SetFromErrno(PyExc_OSError);
+            break;
+    }
+    MrdbSpool_Free(self);
+    return 1;
+}
+/* }}} */
+
+/* {{{ MrdbSpool_Fetch
+   Returns the next row of the spool: Values will be decoded into
+   self->values, or, if raw values were requested, copied to
+   self->raw_values.
+   Returns 0 on success, 1 if all rows were fetched, or -1 if a column
+   value couldn't be decoded (exception is set) */
+int
+MrdbSpool_Fetch(MrdbCursor *self)
+{
+    MrdbSpool *spool= self->spool;
+    unsigned char *p;
+    uint32_t i, j, length;
+
+    if (spool->position >= spool->row_count)
+        return 1;
+
+    p= spool->data + spool->offsets[spool->position++];
+    for (i= 0; i < spool->field_count; i++)
+    {
+        memcpy(&length, p, sizeof(uint32_t));
+        p+= sizeof(uint32_t);
+        if (length == SPOOL_NULL_LENGTH)
+        {
+            spool->raw[i].data= NULL;
+            spool->raw[i].length= 0;
+            continue;
+        }
+        spool->raw[i].data= p;
+        spool->raw[i].length= length;
+        p+= length + spool->is_text;
+        if (self->measure_bytes)
+            self->row_bytes+= length;
+    }
+
+    if (self->fetch_raw)
+    {
+        memcpy(self->raw_values, spool->raw,
+               spool->field_count * sizeof(MrdbRawValue));
+        return 0;
+    }
+
+    for (i= 0; i < spool->field_count; i++)
+    {
+        if (!(self->values[i]= mariadb_decode_raw_value(self->plan, i,
+                                                         &spool->raw[i])))
+        {
+            for (j= 0; j < i; j++)
+                Py_CLEAR(self->values[j]);
+            return -1;
+        }
+    }
+    return 0;
+}
+/* }}} */
+
+/* {{{ MrdbSpool_Free */
+void
+MrdbSpool_Free(MrdbCursor *self)
+{
+    MrdbSpool *spool= self->spool;
+
+    if (!spool)
+        return;
+
+    if (spool->mapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(spool->data);
+#else
+        munmap(spool->data, spool->size);
+#endif
+        spool->data= NULL;
+    }
+#ifdef _WIN32
+    if (spool->mapping)
+        CloseHandle(spool->mapping);
+#endif
+    if (spool->file)
+        fclose(spool->file);
+    MARIADB_FREE_MEM(spool->data);
+    MARIADB_FREE_MEM(spool->row_buffer);
+    MARIADB_FREE_MEM(spool->offsets);
+    MARIADB_FREE_MEM(spool->raw);
+    MARIADB_FREE_MEM(self->spool);
+}
+/* }}} */
@@ -119,11 +119,17 @@ setup(name='mariadb',
       install_requires=['packaging'],
       ext_modules=[Extension('mariadb._mariadb',
                              ['mariadb/mariadb.c',
+                              'mariadb/mariadb_arrow.c',
+                              'mariadb/mariadb_blob.c',
                               'mariadb/mariadb_codecs.c',
+                              'mariadb/mariadb_columns.c',
                               'mariadb/mariadb_connection.c',
                               'mariadb/mariadb_cursor.c',
                               'mariadb/mariadb_exception.c',
-                              'mariadb/mariadb_parser.c'],
+                              'mariadb/mariadb_parser.c',
+                              'mariadb/mariadb_prefetch.c',
+                              'mariadb/mariadb_row.c',
+                              'mariadb/mariadb_spool.c'],
                              define_macros=define_macros,
                              include_dirs=cfg.includes,
                              library_dirs=cfg.lib_dirs,
@@ -9,7 +9,8 @@ from benchmarks.benchmark.do_1 import do1
 from benchmarks.benchmark.select_1 import select_1
 from benchmarks.benchmark.do_1000_param import do_1000_param
 from benchmarks.benchmark.select_100_cols import select_100_cols, select_100_cols_execute
-from benchmarks.benchmark.select_1000_rows import select_1000_rows
+from benchmarks.benchmark.select_100_str_cols import select_100_str_cols, select_100_str_cols_execute
+from benchmarks.benchmark.select_1000_rows import select_1000_rows, select_1000_rows_dictionary
 
 
 def run_test(tests, conn, paramstyle):
@@ -27,9 +28,14 @@ def test_suite(paramstyle):
                   'method': do_1000_param},
         {'label': 'select_100_cols',
                   'method': select_100_cols},
+        {'label': 'select_100_str_cols',
+                  'method': select_100_str_cols},
         {'label': 'select 1', 'method': select_1},
         {'label': 'select_1000_rows', 'method': select_1000_rows},
+        {'label': 'select_1000_rows_dictionary',
+                  'method': select_1000_rows_dictionary},
     ]
     if paramstyle == 'qmark':
         ts.append({'label': 'select_100_cols_execute', 'method': select_100_cols_execute})
+        ts.append({'label': 'select_100_str_cols_execute', 'method': select_100_str_cols_execute})
     return ts
@@ -8,7 +8,7 @@ import mariadb
 
 from test.base_test import create_connection, is_skysql, is_maxscale
 from test.conf_test import conf
-from mariadb.constants import STATUS
+from mariadb.constants import STATUS, INFO
 import platform
 from packaging.version import parse as parse_version
 from packaging import version
@@ -242,6 +242,21 @@ class TestConnection(unittest.TestCase):
         con.autocommit = False
         self.assertTrue(not con.server_status & STATUS.AUTOCOMMIT)
 
+    def test_extended_server_capabilities(self):
+        conn = self.connection
+        caps = conn._mariadb_get_info(INFO.EXTENDED_SERVER_CAPABILITIES)
+        self.assertEqual(conn.extended_server_capabilities, caps)
+        conn.reconnect()
+        self.assertEqual(conn.extended_server_capabilities, caps)
+
+    def test_max_allowed_packet_cache(self):
+        conn = self.connection
+        size = conn._get_max_allowed_packet()
+        self.assertEqual(conn._max_allowed_packet, size)
+        conn.reconnect()
+        self.assertEqual(conn._max_allowed_packet, 0)
+        self.assertEqual(conn._get_max_allowed_packet(), size)
+
     def test_conpy175(self):
         default_conf = conf()
         conn = mariadb.connect(**default_conf)
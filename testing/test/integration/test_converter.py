@@ -69,6 +69,38 @@ class TestConversion(unittest.TestCase):
         self.assertEqual(row[0], "None")
         del cursor
 
+    def test_convert_error(self):
+        def fail(s):
+            raise ValueError("conversion failed")
+
+        connection = create_connection({"converter":
+                                        {FIELD_TYPE.VAR_STRING: fail}})
+        cursor = connection.cursor()
+        cursor.execute("SELECT 1, 'foo'")
+        self.assertRaises(ValueError, cursor.fetchone)
+        cursor.execute("SELECT 1, 2")
+        self.assertEqual(cursor.fetchone(), (1, 2))
+        del cursor
+        connection.close()
+
+    def test_convert_executemany(self):
+        # max_allowed_packet must be read without converters
+        connection = create_connection({"converter":
+                                        {FIELD_TYPE.LONGLONG: str}})
+        cursor = connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE t1 (a int, b varchar(10))")
+        stmt = "INSERT INTO t1 VALUES (?, ?)"
+        rows = [(i, "row %d" % i) for i in range(1000)]
+        cursor.executemany(stmt, rows)
+        self.assertEqual(cursor.rowcount, 1000)
+        self.assertEqual(connection._last_executed_statement, stmt)
+        cursor._execute_batch(stmt, iter(rows))
+        self.assertEqual(cursor.rowcount, 1000)
+        cursor.execute("SELECT COUNT(*) FROM t1")
+        self.assertEqual(cursor.fetchone(), ("2000",))
+        del cursor
+        connection.close()
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -1329,6 +1329,13 @@ class TestCursor(unittest.TestCase):
         rows = cursor.fetchall()
         self.assertEqual(rows, [(1, "xyz")])
 
+        # result set of RETURNING must not be split into several requests
+        cursor.executemany("insert into t1 values (?, 'foo') returning a",
+                           ((i,) for i in range(100, 25100)))
+        rows = cursor.fetchall()
+        self.assertEqual(len(rows), 25000)
+        self.assertEqual(rows[-1], (25099,))
+
         del cursor, conn
 
     def test_conpy178(self):
@@ -1682,6 +1689,632 @@ class TestCursor(unittest.TestCase):
                                 [[value, _]] = cursor.fetchall()
                                 self.assertEqual(value, 1)
 
+    def test_column_decode_plan(self):
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute("CREATE TEMPORARY TABLE t_plan (a tinyint, "
+                           "b tinyint unsigned, c smallint, d mediumint, "
+                           "e int, f bigint unsigned, g varchar(10), "
+                           "h varbinary(10), i date)")
+            data = (-1, 255, -2, -3, -4, 18446744073709551615, "foo",
+                    b"bar", datetime.date(2022, 1, 31))
+            cursor.execute("INSERT INTO t_plan VALUES (?,?,?,?,?,?,?,?,?)",
+                           data)
+            cursor.execute("INSERT INTO t_plan VALUES (NULL,NULL,NULL,NULL,"
+                           "NULL,NULL,NULL,NULL,NULL)")
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(binary=binary)
+                    cursor.execute("SELECT * FROM t_plan")
+                    rows = cursor.fetchall()
+                    self.assertEqual(rows[0], data)
+                    self.assertEqual(rows[1], (None,) * 9)
+                    cursor.close()
+
+    def test_text_numeric(self):
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute("SELECT CAST(18446744073709551615 AS UNSIGNED), "
+                           "-9223372036854775808, 0, -0, "
+                           "CAST(0.1 AS DOUBLE), CAST(1.7976931348623157e308 "
+                           "AS DOUBLE), CAST(-2.2250738585072014e-308 AS "
+                           "DOUBLE)")
+            row = cursor.fetchone()
+            self.assertEqual(row, (18446744073709551615, -9223372036854775808,
+                                   0, 0, 0.1, 1.7976931348623157e308,
+                                   -2.2250738585072014e-308))
+            cursor.close()
+
+    def test_decimal_format(self):
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute("CREATE TEMPORARY TABLE t_dec (a decimal(10,2), "
+                           "b decimal(40,5), c decimal(5,0))")
+            cursor.execute("INSERT INTO t_dec VALUES (-12.5, "
+                           "123456789012345678901234567890.12345, 7)")
+            cursor.close()
+            expected = {"decimal": (Decimal("-12.50"),
+                                    Decimal("123456789012345678901234567890"
+                                            ".12345"),
+                                    Decimal("7")),
+                        "str": ("-12.50",
+                                "123456789012345678901234567890.12345",
+                                "7"),
+                        "float": (-12.5, 1.2345678901234568e+29, 7.0),
+                        "int": (-1250,
+                                12345678901234567890123456789012345,
+                                7)}
+            for fmt, row in expected.items():
+                for binary in (False, True):
+                    with self.subTest(decimal_format=fmt, binary=binary):
+                        cursor = connection.cursor(binary=binary,
+                                                   decimal_format=fmt)
+                        cursor.execute("SELECT * FROM t_dec")
+                        self.assertEqual(cursor.fetchone(), row)
+                        cursor.close()
+            self.assertRaises(mariadb.ProgrammingError, connection.cursor,
+                              decimal_format="money")
+
+        with create_connection({"decimal_format": "str"}) as connection:
+            cursor = connection.cursor()
+            cursor.execute("SELECT CAST(1.5 AS DECIMAL(5,2))")
+            self.assertEqual(cursor.fetchone()[0], "1.50")
+            cursor.close()
+
+    def test_ascii_strings(self):
+        with create_connection() as connection:
+            values = ("", "a", "abcdefghijklmnopqrstuvwxyz0123456789" * 3,
+                      "abcdefghijklmnopqrstuvwxyz0123456789" * 3 + "\u00e4",
+                      "\U0001f31f" + "x" * 40)
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(binary=binary)
+                    cursor.execute("SELECT ?, ?, ?, ?, ?", values)
+                    row = cursor.fetchone()
+                    self.assertEqual(row, values)
+                    cursor.close()
+
+    def test_intern_strings(self):
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute("CREATE TEMPORARY TABLE t_intern (a enum('red', "
+                           "'green', 'blue'), b varchar(20), c varchar(100))")
+            data = [(("red", "green", "blue")[i % 3], "status%d" % (i % 2),
+                     "unique value %d" % i) for i in range(3000)]
+            cursor.executemany("INSERT INTO t_intern VALUES (?,?,?)", data)
+            cursor.close()
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(binary=binary,
+                                               intern_strings=True)
+                    cursor.execute("SELECT a, b, c FROM t_intern")
+                    rows = cursor.fetchall()
+                    self.assertEqual(rows, data)
+                    self.assertIs(rows[0][0], rows[3][0])
+                    self.assertIs(rows[0][1], rows[2][1])
+                    cursor.close()
+            # ENUM and SET values are cached without intern_strings
+            for binary in (False, True):
+                with self.subTest(binary=binary, intern_strings=False):
+                    cursor = connection.cursor(binary=binary)
+                    cursor.execute("SELECT a FROM t_intern")
+                    rows = cursor.fetchall()
+                    self.assertEqual(rows, [(row[0],) for row in data])
+                    self.assertIs(rows[0][0], rows[3][0])
+                    self.assertIs(rows[1][0], rows[2998][0])
+                    cursor.close()
+
+    def test_temporal_cache(self):
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute("CREATE TEMPORARY TABLE t_temporal (a date, "
+                           "b datetime(6), c datetime, d timestamp(3) NULL)")
+            data = [(datetime.date(2022, 1 + i % 12, 1 + i % 28),
+                     datetime.datetime(2022, 3, 1, 12, 0, 0, 1000 * (i % 2)),
+                     datetime.datetime(1999, 12, 31, 23, 59, i % 60),
+                     datetime.datetime(2020, 2, 29, 1, 2, 3, 456000))
+                    for i in range(100)]
+            cursor.executemany("INSERT INTO t_temporal VALUES (?,?,?,?)",
+                               data)
+            cursor.close()
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(binary=binary)
+                    cursor.execute("SELECT * FROM t_temporal")
+                    rows = cursor.fetchall()
+                    self.assertEqual(rows, data)
+                    self.assertIs(rows[0][1], rows[2][1])
+                    self.assertIs(rows[0][3], rows[1][3])
+                    cursor.close()
+
+    def test_dictionary_rows(self):
+        with create_connection() as connection:
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(dictionary=True, binary=binary)
+                    cursor.execute("SELECT 1 AS a, NULL AS b, 'x' AS c "
+                                   "UNION SELECT 2, 3, 'y'")
+                    rows = cursor.fetchall()
+                    self.assertEqual(rows, [{"a": 1, "b": None, "c": "x"},
+                                            {"a": 2, "b": 3, "c": "y"}])
+                    rows[0]["d"] = 4
+                    self.assertNotIn("d", rows[1])
+                    cursor.execute("SELECT 1 AS a, 2 AS a")
+                    self.assertEqual(cursor.fetchone(), {"a": 2})
+                    cursor.close()
+
+    def test_named_tuple_type_cache(self):
+        with create_connection() as connection:
+            cursor = connection.cursor(named_tuple=True)
+            cursor.execute("SELECT 1 AS a, 2 AS b")
+            row1 = cursor.fetchone()
+            cursor.execute("SELECT 3 AS a, 4 AS b")
+            row2 = cursor.fetchone()
+            self.assertIs(type(row1), type(row2))
+            self.assertEqual((row1.a, row1.b, row2.a, row2.b), (1, 2, 3, 4))
+            cursor.execute("SELECT 1 AS b, 2 AS a")
+            row3 = cursor.fetchone()
+            self.assertIsNot(type(row1), type(row3))
+            self.assertEqual((row3.a, row3.b), (2, 1))
+            cursor.execute("SELECT 1 AS _fields")
+            self.assertEqual(cursor.fetchone()._fields, 1)
+            # type must stay valid after the result set was released
+            cursor.close()
+            self.assertEqual(repr(row1), "mariadb.Row(a=1, b=2)")
+
+    def test_lazy_rows(self):
+        with create_connection() as connection:
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(lazy=True, binary=binary)
+                    cursor.execute("SELECT 1 AS a, NULL AS b, 'x' AS c, "
+                                   "CAST('2022-01-02' AS DATE) AS d, "
+                                   "1.5 AS e UNION SELECT 2, 3, 'y', NULL, "
+                                   "NULL")
+                    rows = cursor.fetchall()
+                    self.assertEqual(len(rows), 2)
+                    self.assertIsInstance(rows[0], mariadb.LazyRow)
+                    self.assertEqual(len(rows[0]), 5)
+                    self.assertEqual(rows[0][0], 1)
+                    self.assertEqual(rows[0]["c"], "x")
+                    self.assertEqual(rows[0][-2], datetime.date(2022, 1, 2))
+                    self.assertEqual(rows[0][1:3], (None, "x"))
+                    self.assertEqual(rows[0][4], Decimal("1.5"))
+                    self.assertEqual(rows[1].materialize(),
+                                     (2, 3, "y", None, None))
+                    self.assertEqual(rows[1], (2, 3, "y", None, None))
+                    self.assertRaises(KeyError, rows[0].__getitem__, "z")
+                    self.assertRaises(IndexError, rows[0].__getitem__, 5)
+                    # rows remain valid after the result set was freed
+                    cursor.execute("SELECT 1")
+                    self.assertEqual(tuple(rows[1]), (2, 3, "y", None, None))
+                    cursor.close()
+            # named_tuple takes precedence
+            cursor = connection.cursor(lazy=True, named_tuple=True)
+            cursor.execute("SELECT 1 AS a")
+            self.assertEqual(cursor.fetchone().a, 1)
+            cursor.close()
+
+    def test_fetch_columns(self):
+        with create_connection() as connection:
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(binary=binary)
+                    cursor.execute("SELECT 1 AS a, 'abc' AS b, "
+                                   "CAST('1970-01-02' AS DATE) AS c, "
+                                   "CAST('1970-01-01 00:00:01.5' AS "
+                                   "DATETIME(6)) AS d, 0.5e0 AS e "
+                                   "UNION SELECT -2, NULL, NULL, NULL, NULL")
+                    columns = cursor.fetch_columns()
+                    self.assertIsInstance(columns[0], mariadb.ColumnBuffer)
+                    self.assertEqual([c.name for c in columns],
+                                     ["a", "b", "c", "d", "e"])
+                    self.assertEqual([c.type for c in columns],
+                                     ["int64", "utf8", "date32",
+                                      "timestamp[us]", "double"])
+                    self.assertEqual(len(columns[0]), 2)
+                    self.assertEqual(memoryview(columns[0]).tolist(), [1, -2])
+                    self.assertEqual(memoryview(columns[2])[0], 1)
+                    self.assertEqual(memoryview(columns[3])[0], 1500000)
+                    self.assertEqual(memoryview(columns[4])[0], 0.5)
+                    self.assertEqual(bytes(columns[1]), b"abc")
+                    self.assertEqual(memoryview(columns[1].offsets).cast("q")
+                                     .tolist(), [0, 3, 3])
+                    for column in columns[1:]:
+                        self.assertEqual(column.null_count, 1)
+                        self.assertEqual(column.validity, b"\x01")
+                    self.assertEqual(columns[0].validity, b"\x03")
+                    self.assertEqual(len(cursor.fetch_columns()[0]), 0)
+                    cursor.close()
+
+    def test_arrow_c_stream(self):
+        with create_connection() as connection:
+            cursor = connection.cursor(arrow_batch_size=2)
+            cursor.execute("SELECT 1 AS a, 'abc' AS b, 1.25 AS c, "
+                           "CAST('2022-01-02 03:04:05' AS DATETIME) AS d "
+                           "UNION SELECT 2, NULL, -2.5, NULL "
+                           "UNION SELECT 3, 'x', 0, NULL")
+            capsule = cursor.__arrow_c_stream__()
+            self.assertEqual(type(capsule).__name__, "PyCapsule")
+            del capsule
+            try:
+                import pyarrow
+            except ImportError:
+                self.skipTest("pyarrow not available")
+            reader = pyarrow.RecordBatchReader.from_stream(cursor)
+            self.assertEqual(reader.schema.names, ["a", "b", "c", "d"])
+            self.assertTrue(str(reader.schema.field("c").type)
+                            .startswith("decimal128("))
+            self.assertEqual(str(reader.schema.field("d").type),
+                             "timestamp[us]")
+            batches = list(reader)
+            self.assertEqual([batch.num_rows for batch in batches], [2, 1])
+            table = pyarrow.Table.from_batches(batches)
+            self.assertEqual(table.column("a").to_pylist(), [1, 2, 3])
+            self.assertEqual(table.column("b").to_pylist(), ["abc", None, "x"])
+            self.assertEqual(table.column("c").to_pylist(),
+                             [Decimal("1.25"), Decimal("-2.50"),
+                              Decimal("0.00")])
+            self.assertEqual(table.column("d").to_pylist()[0],
+                             datetime.datetime(2022, 1, 2, 3, 4, 5))
+            cursor.close()
+
+    def test_arrow_decimal128_precision(self):
+        try:
+            import pyarrow
+        except ImportError:
+            self.skipTest("pyarrow not available")
+        values = ["0.12345678901234567890123456789012345678",
+                  "-0.00000000000000000000000000000000000001"]
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute("SELECT CAST('%s' AS DECIMAL(38,38)) AS a "
+                           "UNION ALL SELECT CAST('%s' AS DECIMAL(38,38))" %
+                           tuple(values))
+            table = pyarrow.RecordBatchReader.from_stream(cursor).read_all()
+            self.assertEqual(str(table.schema.field("a").type),
+                             "decimal128(38, 38)")
+            self.assertEqual(table.column("a").to_pylist(),
+                             [Decimal(value) for value in values])
+            cursor.close()
+
+    def test_fetchall_remaining(self):
+        stmt = " UNION ALL ".join("SELECT %d AS seq" % i
+                                  for i in range(1, 11))
+        with create_connection() as connection:
+            for options in ({}, {"dictionary": True}, {"named_tuple": True},
+                            {"binary": True}):
+                with self.subTest(**options):
+                    cursor = connection.cursor(buffered=True, **options)
+                    cursor.execute(stmt)
+                    cursor.fetchone()
+                    self.assertEqual(len(cursor.fetchmany(3)), 3)
+                    cursor.scroll(-2)
+                    rows = cursor.fetchall()
+                    self.assertEqual(len(rows), 8)
+                    if options.get("dictionary"):
+                        self.assertEqual(rows[0]["seq"], 3)
+                    else:
+                        self.assertEqual(rows[0][0], 3)
+                    self.assertEqual(cursor.fetchall(), [])
+                    self.assertEqual(cursor.rowcount, 10)
+                    cursor.close()
+            cursor = connection.cursor(buffered=False)
+            cursor.execute(stmt)
+            cursor.fetchone()
+            self.assertEqual(len(cursor.fetchall()), 9)
+            cursor.close()
+            self.assertRaises(mariadb.ProgrammingError, cursor.fetchall)
+
+    def test_iterator(self):
+        stmt = " UNION ALL ".join("SELECT %d AS seq" % i
+                                  for i in range(1, 201))
+        with create_connection() as connection:
+            for buffered in (True, False):
+                with self.subTest(buffered=buffered):
+                    cursor = connection.cursor(buffered=buffered)
+                    cursor.execute(stmt)
+                    self.assertIs(iter(cursor), cursor)
+                    for row in cursor:
+                        if row[0] == 100:
+                            break
+                    self.assertEqual(cursor.rownumber, 100)
+                    self.assertEqual(cursor.fetchone(), (101,))
+                    rows = [row[0] for row in cursor]
+                    self.assertEqual(rows, list(range(102, 201)))
+                    self.assertEqual(list(cursor), [])
+                    cursor.close()
+                    if not buffered:
+                        self.assertRaises(mariadb.ProgrammingError, iter,
+                                          cursor)
+            cursor = connection.cursor()
+            cursor.execute("DO 1")
+            self.assertRaises(mariadb.ProgrammingError, iter, cursor)
+            cursor.close()
+
+    def test_unbuffered_prefetch(self):
+        stmt = " UNION ALL ".join("SELECT %d AS a, REPEAT('x', %d) AS b, "
+                                  "IF(%d %% 3, NULL, 1.5) AS c" % (i, i, i)
+                                  for i in range(1, 301))
+        with create_connection() as connection:
+            cursor = connection.cursor()
+            cursor.execute(stmt)
+            expected = cursor.fetchall()
+            cursor.close()
+            for binary in (False, True):
+                with self.subTest(binary=binary):
+                    cursor = connection.cursor(buffered=False, binary=binary,
+                                               prefetch=16)
+                    cursor.execute(stmt)
+                    self.assertEqual(cursor.fetchone(), expected[0])
+                    self.assertEqual(cursor.fetchmany(9), expected[1:10])
+                    self.assertEqual(cursor.rowcount, 10)
+                    self.assertEqual(list(cursor), expected[10:])
+                    self.assertEqual(cursor.fetchone(), None)
+                    # pending rows will be discarded by next execute
+                    cursor.execute(stmt)
+                    cursor.fetchmany(20)
+                    cursor.execute("SELECT 1")
+                    self.assertEqual(cursor.fetchall(), [(1,)])
+                    cursor.close()
+            cursor = connection.cursor(buffered=False, lazy=True,
+                                       prefetch=True)
+            cursor.execute(stmt)
+            self.assertEqual([tuple(row) for row in cursor], expected)
+            cursor.close()
+
+    def test_fetch_size(self):
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_fetch_size "
+                       "(a int, b varchar(100))")
+        cursor.executemany("INSERT INTO test_fetch_size VALUES (?, ?)",
+                           [(i, "x" * (i % 100)) for i in range(1, 1001)])
+        cursor.close()
+        for fetch_size in (1, 50, "auto"):
+            with self.subTest(fetch_size=fetch_size):
+                cursor = self.connection.cursor(cursor_type=CURSOR.READ_ONLY,
+                                                buffered=False,
+                                                fetch_size=fetch_size,
+                                                fetch_buffer_size=4096)
+                cursor.execute("SELECT a, b FROM test_fetch_size ORDER BY a")
+                self.assertEqual(cursor.fetchone(), (1, "x"))
+                rows = cursor.fetchall()
+                self.assertEqual(len(rows), 999)
+                self.assertEqual(rows[-1], (1000, ""))
+                cursor.close()
+        self.assertRaises(mariadb.ProgrammingError, self.connection.cursor,
+                          fetch_size=0)
+
+    def test_fetchmany_max_bytes(self):
+        stmt = " UNION ALL ".join("SELECT REPEAT('x', 1000) AS a"
+                                  for i in range(10))
+        for buffered in (True, False):
+            for binary in (False, True):
+                with self.subTest(buffered=buffered, binary=binary):
+                    cursor = self.connection.cursor(buffered=buffered,
+                                                    binary=binary)
+                    cursor.execute(stmt)
+                    self.assertEqual(len(cursor.fetchmany(max_bytes=2500)),
+                                     3)
+                    self.assertEqual(len(cursor.fetchmany(2, 100000)), 2)
+                    self.assertEqual(len(cursor.fetchmany(max_bytes=1)), 1)
+                    self.assertEqual(len(cursor.fetchall()), 4)
+                    cursor.close()
+        cursor = self.connection.cursor(max_fetch_bytes=4000)
+        cursor.execute(stmt)
+        self.assertEqual(len(cursor.fetchmany()), 4)
+        self.assertEqual(len(cursor.fetchmany(max_bytes=0)), 1)
+        cursor.close()
+
+    def test_blob_as_memoryview(self):
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_blob_view (a int, "
+                       "b blob, c varbinary(20), d varchar(20))")
+        data = [(i, b"\x00blob" * i, b"bin%d" % i, "text%d" % i)
+                for i in range(1, 11)]
+        cursor.executemany("INSERT INTO test_blob_view VALUES (?,?,?,?)", data)
+        cursor.close()
+        for binary in (False, True):
+            with self.subTest(binary=binary):
+                cursor = self.connection.cursor(binary=binary,
+                                                blob_as_memoryview=True)
+                cursor.execute("SELECT a, b, c, d FROM test_blob_view "
+                               "ORDER BY a")
+                rows = cursor.fetchall()
+                self.assertIsInstance(rows[0][1], memoryview)
+                self.assertIsInstance(rows[0][2], memoryview)
+                self.assertIsInstance(rows[0][3], str)
+                self.assertTrue(rows[0][1].readonly)
+                # views remain valid after the result set was replaced
+                cursor.execute("SELECT a, b, c, d FROM test_blob_view "
+                               "ORDER BY a")
+                self.assertEqual(cursor.fetchone()[1], data[0][1])
+                cursor.close()
+                self.assertEqual([(a, bytes(b), bytes(c), d)
+                                  for a, b, c, d in rows], data)
+                del rows
+
+    def test_open_blob(self):
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_open_blob (a int, "
+                       "b longblob, c text)")
+        blob = bytes(range(256)) * 1024
+        cursor.execute("INSERT INTO test_open_blob VALUES (1, ?, ?), "
+                       "(2, NULL, 'abc')", (blob, "\u00e4" * 100))
+        cursor.close()
+        for buffered in (True, False):
+            for binary in (False, True):
+                with self.subTest(buffered=buffered, binary=binary):
+                    cursor = self.connection.cursor(buffered=buffered,
+                                                    binary=binary)
+                    cursor.execute("SELECT a, b, c FROM test_open_blob "
+                                   "ORDER BY a")
+                    row = cursor.fetchone()
+                    self.assertEqual(row[1], blob)
+                    reader = cursor.open_blob(1)
+                    self.assertEqual(reader.length, len(blob))
+                    chunk = bytearray(10000)
+                    data = b""
+                    while True:
+                        count = reader.readinto(chunk)
+                        if not count:
+                            break
+                        data += chunk[:count]
+                    self.assertEqual(data, blob)
+                    reader.seek(-10, 2)
+                    self.assertEqual(reader.read(), blob[-10:])
+                    text = cursor.open_blob("c")
+                    self.assertEqual(text.read().decode(), "\u00e4" * 100)
+                    self.assertRaises(mariadb.ProgrammingError,
+                                      cursor.open_blob, 0)
+                    cursor.fetchone()
+                    self.assertRaises(mariadb.ProgrammingError, reader.read)
+                    self.assertIsNone(cursor.open_blob(1))
+                    self.assertEqual(cursor.open_blob(2).read(), b"abc")
+                    cursor.close()
+
+                with self.subTest(buffered=buffered, binary=binary,
+                                  stream_blobs=True):
+                    # values aren't decoded, rows contain the length only
+                    cursor = self.connection.cursor(buffered=buffered,
+                                                    binary=binary,
+                                                    stream_blobs=True)
+                    cursor.execute("SELECT a, b, c FROM test_open_blob "
+                                   "ORDER BY a")
+                    self.assertEqual(cursor.fetchone(), (1, len(blob), 200))
+                    self.assertEqual(cursor.open_blob("b").read(), blob)
+                    self.assertEqual(cursor.fetchone(), (2, None, 3))
+                    self.assertIsNone(cursor.open_blob(1))
+                    self.assertEqual(cursor.open_blob(2).read(), b"abc")
+                    cursor.close()
+
+    def test_buffer_limit(self):
+        stmt = " UNION ALL ".join("SELECT %d AS a, REPEAT('x', %d) AS b, "
+                                  "IF(%d %% 3, NULL, 1.5) AS c" % (i, i, i)
+                                  for i in range(1, 301))
+        cursor = self.connection.cursor()
+        cursor.execute(stmt)
+        expected = cursor.fetchall()
+        cursor.close()
+        for buffer_limit in (100, 1000000):
+            for binary in (False, True):
+                with self.subTest(buffer_limit=buffer_limit, binary=binary):
+                    cursor = self.connection.cursor(binary=binary,
+                                                    buffer_limit=buffer_limit)
+                    cursor.execute(stmt)
+                    self.assertEqual(cursor.rowcount, 300)
+                    self.assertEqual(cursor.fetchone(), expected[0])
+                    self.assertEqual(list(cursor), expected[1:])
+                    cursor.scroll(200, mode="absolute")
+                    self.assertEqual(cursor.fetchmany(2), expected[200:202])
+                    cursor.scroll(0, mode="absolute")
+                    self.assertEqual(cursor.fetchall(), expected)
+                    # connection can be used while the result is buffered
+                    self.connection.ping()
+                    cursor.close()
+        self.assertRaises(mariadb.ProgrammingError, self.connection.cursor,
+                          buffer_limit=-1)
+
+    def test_executemany_widen(self):
+        if is_mysql():
+            self.skipTest("Skip (MySQL doesn't support bulk operations)")
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_widen (a int, "
+                       "b decimal(30,2), c double, d decimal(30,0), "
+                       "e varchar(10), f time)")
+        data = [(1, 1, 1, -1, "foo", datetime.timedelta(hours=-1)),
+                (None, 1.5, 2.5, 2 ** 64, None, datetime.time(12, 0)),
+                (-300, Decimal("3.25"), 3, 5, "bar", None),
+                (True, None, None, None, "", datetime.time(1, 2, 3))]
+        cursor.executemany("INSERT INTO test_widen VALUES (?,?,?,?,?,?)",
+                           data)
+        self.assertEqual(cursor.rowcount, 4)
+        cursor.execute("SELECT * FROM test_widen")
+        rows = cursor.fetchall()
+        self.assertEqual([row[0] for row in rows], [1, None, -300, 1])
+        self.assertEqual([row[1] for row in rows],
+                         [Decimal("1.00"), Decimal("1.50"), Decimal("3.25"),
+                          None])
+        self.assertEqual([row[2] for row in rows], [1.0, 2.5, 3.0, None])
+        self.assertEqual([row[3] for row in rows],
+                         [Decimal(-1), Decimal(2 ** 64), Decimal(5), None])
+        self.assertEqual(rows[1][5], datetime.timedelta(hours=12))
+        self.assertRaises(mariadb.ProgrammingError, cursor.executemany,
+                          "INSERT INTO test_widen (a) VALUES (?)",
+                          [(1,), ("a",)])
+        cursor.close()
+
+    def test_executemany_columnar(self):
+        import array
+        import types
+
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_columnar (a bigint, "
+                       "b double, c smallint unsigned, d float)")
+        a = array.array("q", [1, -2, 2 ** 40])
+        b = types.SimpleNamespace(data=array.array("d", [1.5, 2.5, 3.5]),
+                                  mask=bytes([0, 1, 0]))
+        c = memoryview(array.array("H", [1, 2, 65535]))
+        d = array.array("f", [0.5, 1.5, 2.5])
+        cursor.executemany("INSERT INTO test_columnar VALUES (?,?,?,?)",
+                           [a, b, c, d])
+        self.assertEqual(cursor.rowcount, 3)
+        cursor.executemany("INSERT INTO test_columnar VALUES "
+                           "(%(a)s, %(b)s, 0, 0)", {"b": d, "a": a})
+        cursor.execute("SELECT * FROM test_columnar")
+        self.assertEqual(cursor.fetchall(),
+                         [(1, 1.5, 1, 0.5), (-2, None, 2, 1.5),
+                          (2 ** 40, 3.5, 65535, 2.5),
+                          (1, 0.5, 0, 0.0), (-2, 1.5, 0, 0.0),
+                          (2 ** 40, 2.5, 0, 0.0)])
+        self.assertRaises(mariadb.ProgrammingError, cursor.executemany,
+                          "INSERT INTO test_columnar (a, b) VALUES (?,?)",
+                          [a, d[:2]])
+        cursor.close()
+
+    def test_executemany_iterator(self):
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_iterator (a int, "
+                       "b varchar(100))")
+        rows = ((i, "x" * (i % 100)) for i in range(25000))
+        cursor.executemany("INSERT INTO test_iterator VALUES (?,?)", rows)
+        self.assertEqual(cursor.rowcount, 25000)
+        cursor.executemany("INSERT INTO test_iterator VALUES (?,?)",
+                           [(i, "y" * 100) for i in range(50000)])
+        self.assertEqual(cursor.rowcount, 50000)
+        cursor.execute("SELECT COUNT(*), SUM(a), SUM(LENGTH(b)) "
+                       "FROM test_iterator")
+        self.assertEqual(cursor.fetchone(),
+                         (75000, 1562462500, 1237500 + 5000000))
+        self.assertRaises(mariadb.ProgrammingError, cursor.executemany,
+                          "INSERT INTO test_iterator VALUES (?,?)", iter(()))
+        cursor.close()
+
+    def test_executemany_rewrite(self):
+        cursor = self.connection.cursor()
+        cursor.execute("CREATE TEMPORARY TABLE test_rewrite (a int primary "
+                       "key, b varchar(20), c int)")
+        # emulation of executemany() if the server doesn't support bulk
+        # operations
+        rows = [(i, "row %d" % i) for i in range(50000)]
+        cursor._execute_batch("INSERT INTO test_rewrite VALUES (?, ?, 1)",
+                              iter(rows))
+        self.assertEqual(cursor.rowcount, 50000)
+        self.assertEqual(cursor.statement.count("(?, ?, 1)"), 50000 - 32767)
+        rows = [{"a": 1, "b": "x"}, {"a": 2, "b": "y"}]
+        cursor._execute_batch("INSERT INTO test_rewrite VALUES "
+                              "(%(a)s, %(b)s, 2) ON DUPLICATE KEY UPDATE "
+                              "b=VALUES(b), c=VALUES(c)", iter(rows))
+        self.assertEqual(cursor.rowcount, 4)
+        cursor._execute_batch("UPDATE test_rewrite SET c=3 WHERE a=?",
+                              iter([(3,), (4,)]))
+        self.assertEqual(cursor.rowcount, 2)
+        cursor.execute("SELECT COUNT(*), SUM(c) FROM test_rewrite")
+        self.assertEqual(cursor.fetchone(), (50000, 50000 + 2 + 4))
+        cursor.execute("SELECT b FROM test_rewrite WHERE a IN (1, 49999)")
+        self.assertEqual(cursor.fetchall(), [("x",), ("row 49999",)])
+        cursor.close()
+
 
 if __name__ == '__main__':
     unittest.main()